@@ -0,0 +1,102 @@
+import sys
+import subprocess
+from pathlib import Path
+
+from perf_report import report
+
+# Runs the simulator comparisons described in perf_report.py and records each
+# as benchmarks/<name>.txt next to this script: the perf_report table, the
+# runs behind it and every run that failed (with the reason), so the numbers
+# can be committed with the code they measure. Run from the ns-3 top-level
+# directory (the one with ./ns3), e.g.
+#
+#   python <path to>/Pipeline/benchmark.py monitor
+#
+# Archives go to outputs/benchmarks/ under the working directory.
+
+RESULTS = Path(__file__).resolve().parent / "benchmarks"
+ARCHIVES = Path("outputs/benchmarks")
+TIMEOUT = 6 * 3600    # seconds per run
+
+# name -> (perf_report --by keys, --with keys, [(run name, program, arguments)])
+COMPARISONS = {
+    # FlowMonitor probes on every node vs only on endpoints, 200-camera airport.
+    "monitor": ("monitor", [], [
+        (f"monitor-{m}", "airport", ["--firstScenario=50", "--scenarios=3", "--jobs=3", f"--monitor={m}"])
+        for m in ["all", "endpoints"]
+    ]),
+    # Routing setup (stack_s + routing_s, their _rss_kb, peak_rss_kb) by
+    # camera count. Sizes that fail, e.g. global SPF running out of memory at
+    # 5000 cameras, are listed with the reason, so the table shows the
+    # largest size each mode manages.
+    "routing": ("routing.mode,num_cameras", ["routing.routes"], [
+        (f"routing-{n}-{r}", "airport", ["--scenarios=1", f"--cameras={n}", f"--routing={r}"])
+        for n in [200, 1000, 5000] for r in ["global", "tree", "nix"]
+    ]),
+    # Events and early loss (startup.*, one second after the apps start) that
+    # pre-populated neighbour caches remove, in both simulators.
+    "populate_arp": ("populate_arp", [], [
+        (f"arp-airport-{p}", "airport", ["--firstScenario=50", "--scenarios=3", "--jobs=3", f"--populateArp={p}"])
+        for p in ["false", "true"]
+    ]),
+    "populate_arp_warehouse": ("populate_arp", [], [
+        (f"arp-warehouse-{p}", "warehouse", ["--scenarios=10", "--jobs=0", f"--populateArp={p}"])
+        for p in ["false", "true"]
+    ]),
+}
+
+def run(ns3, program, args, archive, timeout):
+    """Runs one simulation into archive; returns None, or why it failed."""
+    archive.unlink(missing_ok=True)
+    command = " ".join([program] + args + [f"--archive={archive.resolve()}"])
+    try:
+        result = subprocess.run([ns3, "run", command], capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return f"timed out after {timeout} s"
+    if result.returncode < 0:
+        return f"killed by signal {-result.returncode} (SIGKILL is usually the OOM killer)"
+    if result.returncode != 0:
+        last = result.stderr.strip().splitlines()[-1:] or [""]
+        return f"exit status {result.returncode}: {last[0]}"
+    if not archive.exists():
+        return "no output"
+    return None
+
+def benchmark(name, ns3, timeout):
+    by, extra, runs = COMPARISONS[name]
+    ARCHIVES.mkdir(parents=True, exist_ok=True)
+    lines, failed, archives = [], [], []
+    for label, program, args in runs:
+        archive = ARCHIVES / f"{label}.arc"
+        print(f"{name}: {program} {' '.join(args)}", flush=True)
+        error = run(ns3, program, args, archive, timeout)
+        lines.append(f"# {label}: {program} {' '.join(args)}")
+        if error:
+            failed.append(f"# failed {label}: {error}")
+        else:
+            archives.append(archive)
+
+    lines += failed + [""] + (report(by, archives, extra) if archives else ["(no run succeeded)"])
+    RESULTS.mkdir(exist_ok=True)
+    (RESULTS / f"{name}.txt").write_text("\n".join(lines) + "\n")
+    print("\n".join(lines))
+
+def main(args):
+    ns3, timeout = "./ns3", TIMEOUT
+    while args and args[0].startswith("--"):
+        option, _, value = args.pop(0).partition("=")
+        if option == "--ns3":
+            ns3 = value
+        elif option == "--timeout":
+            timeout = int(value)
+    unknown = [a for a in args if a not in COMPARISONS]
+    if not args or unknown:
+        print(f"usage: {sys.argv[0]} [--ns3=<launcher>] [--timeout=<s>] {'|'.join(COMPARISONS)}...")
+        return 1
+
+    for name in args:
+        benchmark(name, ns3, timeout)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -1,6 +1,8 @@
 import os
 import pandas as pd
 
+# network_log.csv is written per scenario by the simulators with --queueStep
+# (per node and step: queue_size in packets, throughput Mbit/s, delay ms, loss).
 RAW = "dataset/raw"
 OUT = "dataset/rag_docs"
 os.makedirs(OUT, exist_ok=True)
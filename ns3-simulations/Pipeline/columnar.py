@@ -0,0 +1,29 @@
+import struct
+import numpy as np
+
+# Reader for the fixed-width columnar files written by columnar-file.h
+# (flow.bin and friends). Columns are returned as zero-copy numpy views
+# over a memory map of the file.
+
+MAGIC = b"COLSTAT1"
+DTYPES = {1: "<u1", 2: "<u2", 3: "<u4", 4: "<u8", 5: "<i8", 6: "<f8"}
+
+def read_columns(source):
+    """Return {column name: numpy array} for a path or a bytes-like buffer."""
+    if isinstance(source, (bytes, bytearray, memoryview)):
+        raw = np.frombuffer(source, dtype=np.uint8)
+    else:
+        raw = np.memmap(source, dtype=np.uint8, mode="r")
+
+    magic, version, ncols, nrows = struct.unpack_from("<8sIIQ", raw, 0)
+    if magic != MAGIC:
+        raise ValueError("not a columnar stats file")
+
+    columns = {}
+    pos = 24
+    for _ in range(ncols):
+        name, ctype, width, offset = struct.unpack_from("<32sBB6xQ", raw, pos)
+        pos += 48
+        name = name.rstrip(b"\0").decode()
+        columns[name] = raw[offset:offset + nrows * width].view(DTYPES[ctype])
+    return columns
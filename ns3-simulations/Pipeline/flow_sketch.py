@@ -0,0 +1,79 @@
+import sys
+import json
+from pathlib import Path
+
+import numpy as np
+
+from columnar import read_columns
+from scenario_archive import ScenarioArchive
+
+# Merges the per-flow delay/jitter sketches (flow_sketch.bin, written with
+# --flowSketch) of many scenarios and prints tail quantiles per destination
+# port, i.e. per traffic class. Each argument is a scenario directory tree or
+# a scenario archive, e.g.
+#
+#   ./ns3 run "warehouse --scenarios=20 --flowSketch --archive=sk.arc"
+#   python flow_sketch.py sk.arc
+#
+# Bucket k holds values in (gamma^(k-1), gamma^k] ns, gamma = (1+a)/(1-a),
+# bucket -1 values below 1 ns; merging is adding counts per bucket, so the
+# merged quantiles keep the relative error a of the single sketches.
+
+QUANTILES = [0.5, 0.9, 0.99, 0.999]
+METRICS = {0: "delay", 1: "jitter"}
+
+def scenarios(path):
+    """Yield (config, flow_sketch.bin bytes) per scenario that has sketches."""
+    path = Path(path)
+    if path.is_file():
+        with ScenarioArchive(path) as archive:
+            for scenario in archive.ids():
+                files = archive.get(scenario)
+                if "flow_sketch.bin" in files and "config.json" in files:
+                    yield json.loads(files["config.json"]), files["flow_sketch.bin"]
+        return
+
+    for sketch in sorted(path.glob("*/flow_sketch.bin")):
+        config = sketch.parent / "config.json"
+        yield json.loads(config.read_text()) if config.exists() else {}, sketch.read_bytes()
+
+def quantile(buckets, gamma, q):
+    """buckets: {bucket: count}; value (ns) at quantile q."""
+    keys = sorted(buckets)
+    counts = np.array([buckets[k] for k in keys], dtype=np.uint64)
+    rank = int(q * (int(counts.sum()) - 1))
+    k = keys[int(np.searchsorted(np.cumsum(counts), rank, side="right"))]
+    return 0.0 if k < 0 else 2.0 * gamma ** k / (gamma + 1)
+
+def main(args):
+    if not args:
+        print(f"usage: {sys.argv[0]} <outputs dir | archive>...")
+        return 1
+
+    alpha = None
+    merged = {}    # (dst_port, metric) -> {bucket: count}
+    for source in args:
+        for config, sketch in scenarios(source):
+            a = config.get("flow_sketch", {}).get("alpha")
+            if alpha is None:
+                alpha = a
+            elif a is not None and a != alpha:
+                raise ValueError(f"cannot merge sketches with alpha {alpha} and {a}")
+            cols = read_columns(sketch)
+            for port, metric, bucket, count in zip(cols["dst_port"], cols["metric"], cols["bucket"], cols["count"]):
+                buckets = merged.setdefault((int(port), int(metric)), {})
+                buckets[int(bucket)] = buckets.get(int(bucket), 0) + int(count)
+
+    if not merged:
+        print("no flow_sketch.bin found")
+        return 1
+    gamma = (1 + (alpha or 0.01)) / (1 - (alpha or 0.01))
+
+    print(f"{'dst_port':<10}{'metric':<8}{'packets':>12}" + "".join(f"{f'p{q * 100:g}_ms':>14}" for q in QUANTILES))
+    for (port, metric), buckets in sorted(merged.items()):
+        row = [quantile(buckets, gamma, q) / 1e6 for q in QUANTILES]
+        print(f"{port:<10}{METRICS[metric]:<8}{sum(buckets.values()):>12}" + "".join(f"{v:>14.4f}" for v in row))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
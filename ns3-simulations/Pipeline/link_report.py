@@ -0,0 +1,51 @@
+import sys
+import json
+from pathlib import Path
+
+from scenario_archive import ScenarioArchive
+
+# Prints the link/BSS utilization ranking the simulators write with
+# --linkStep (link_report.json), one block per scenario, e.g.
+#
+#   ./ns3 run "airport --scenarios=5 --linkStep=0.1 --hotLinks=3 --archive=links.arc"
+#   python link_report.py --top=10 links.arc
+#
+# Utilization of a link is its busier direction relative to its DataRate,
+# of a BSS the share of airtime its members spent transmitting.
+
+def reports(path):
+    path = Path(path)
+    if path.is_file():
+        with ScenarioArchive(path) as archive:
+            for scenario in archive.ids():
+                files = archive.get(scenario)
+                if "link_report.json" in files:
+                    yield f"scenario_{scenario:04d}", json.loads(files["link_report.json"])
+        return
+
+    for report in sorted(path.glob("*/link_report.json")):
+        yield report.parent.name, json.loads(report.read_text())
+
+def main(args):
+    top = 10
+    if args and args[0].startswith("--top="):
+        top = int(args.pop(0)[len("--top="):])
+    if not args:
+        print(f"usage: {sys.argv[0]} [--top=<links>] <outputs dir | archive>...")
+        return 1
+
+    for source in args:
+        for name, report in reports(source):
+            print(f"{name}  (step {report['step_s']} s, {report['samples']} samples)")
+            print(f"  {'rank':>4}  {'kind':<4}  {'name':<28}{'peak':>8}{'at_s':>8}{'mean':>8}{'flows':>7}")
+            for link in report["links"][:top]:
+                flows = len(link["flows"]) if "flows" in link else ""
+                print(f"  {link['rank']:>4}  {link['kind']:<4}  {link['name'][:27]:<28}"
+                      f"{link['peak']:>8.3f}{link['peak_time_s']:>8.2f}{link['mean']:>8.3f}{flows:>7}")
+                for flow in link.get("flows", [])[:5]:
+                    print(f"        flow {flow['flow_id']:>5} {flow['src']} -> {flow['dst']}:{flow['dst_port']}"
+                          f"  {flow['throughput_bps'] / 1e6:.2f} Mbit/s")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
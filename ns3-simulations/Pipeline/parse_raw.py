@@ -3,7 +3,11 @@ import json
 import xml.etree.ElementTree as ET
 from pathlib import Path
 
+from columnar import read_columns
+from scenario_archive import ScenarioArchive
+
 RAW_DIR = Path("outputs/airport2_scenarios")
+RAW_ARCHIVE = Path("outputs/airport2_scenarios.arc")  # used instead of RAW_DIR if present
 OUT_DIR = Path("dataset2")  
 
 def parse_ns3_val(val, type_func, default=0):
@@ -40,40 +44,96 @@ def parse_flow(flow):
         "throughput": (rx_bytes * 8) / duration 
     }
 
-def parse_scenario(path):
-    config_path = path / "config.json"
-    
-    if config_path.exists():
-        config = json.load(open(config_path))
+def parse_flow_columns(source):
+    """Same records as parse_flow, read from a columnar flow.bin."""
+    cols = read_columns(source)
+    flows = []
+    for i in range(len(cols["flow_id"])):
+        t_first_tx = float(cols["first_tx_time_ns"][i])
+        t_last_rx = float(cols["last_rx_time_ns"][i])
+        duration = t_last_rx - t_first_tx
+        if duration <= 1e-9:
+            duration = 1.0
+
+        flows.append({
+            "flow_id": int(cols["flow_id"][i]),
+            "tx_packets": int(cols["tx_packets"][i]),
+            "rx_packets": int(cols["rx_packets"][i]),
+            "lost_packets": int(cols["lost_packets"][i]),
+            "delay_sum": float(cols["delay_sum_ns"][i]),
+            "jitter_sum": float(cols["jitter_sum_ns"][i]),
+            "first_tx_time": t_first_tx,
+            "last_tx_time": float(cols["last_tx_time_ns"][i]),
+            "first_rx_time": float(cols["first_rx_time_ns"][i]),
+            "last_rx_time": t_last_rx,
+            "throughput": (float(cols["rx_bytes"][i]) * 8) / duration
+        })
+    return flows
+
+def attach_tails(flows, source):
+    """Add the per-flow delay/jitter quantiles of flow_tails.bin (--flowSketch)."""
+    cols = read_columns(source)
+    names = [n for n in cols if n.startswith(("delay_", "jitter_"))]
+    tails = {int(fid): i for i, fid in enumerate(cols["flow_id"])}
+    for flow in flows:
+        i = tails.get(flow["flow_id"])
+        if i is not None:
+            flow.update({n[:-len("_ns")]: float(cols[n][i]) for n in names})
+
+def dir_files(path):
+    return {f.name: f.read_bytes() for f in path.iterdir() if f.is_file()}
+
+def parse_scenario(files):
+    """files: {name: bytes} of one scenario, from a directory or an archive."""
+    if "config.json" in files:
+        config = json.loads(files["config.json"])
     else:
         config = {"scenario": "unknown", "cameras": []}
 
-    tree = ET.parse(path / "flow.xml")
-    root = tree.getroot()
+    if "flow.bin" in files:
+        flows = parse_flow_columns(files["flow.bin"])
+    else:
+        root = ET.fromstring(files["flow.xml"])
 
-    # FIX: Select only statistical flows
-    flows = [parse_flow(f) for f in root.findall("./FlowStats/Flow")]
+        # FIX: Select only statistical flows
+        flows = [parse_flow(f) for f in root.findall("./FlowStats/Flow")]
+    if "flow_tails.bin" in files:
+        attach_tails(flows, files["flow_tails.bin"])
+
+    # One record per camera with its frame and result flow already joined
+    # by the simulator (absent for outputs of older runs).
+    camera_flows = json.loads(files["camera_flows.json"]) if "camera_flows.json" in files else []
 
     return {
         "scenario": config.get("scenario", "unknown"),
         "nodes": config.get("cameras", []),
-        "flows": flows
+        "flows": flows,
+        "camera_flows": camera_flows
     }
 
+def raw_scenarios():
+    """Yield (name, files) from the archive if there is one, else from RAW_DIR."""
+    if RAW_ARCHIVE.exists():
+        with ScenarioArchive(RAW_ARCHIVE) as archive:
+            for scenario in archive.ids():
+                yield f"scenario_{scenario:04d}", archive.get(scenario)
+        return
+
+    for scenario_dir in sorted(RAW_DIR.iterdir()):
+        if scenario_dir.is_dir():
+            yield scenario_dir.name, dir_files(scenario_dir)
+
 OUT_DIR.mkdir(parents=True, exist_ok=True)
 
-if not RAW_DIR.exists():
+if not RAW_DIR.exists() and not RAW_ARCHIVE.exists():
     print(f"Error: Input directory {RAW_DIR} not found.")
 else:
     count = 0
-    for scenario_dir in sorted(RAW_DIR.iterdir()):
-        if not scenario_dir.is_dir():
-            continue
-
+    for name, files in raw_scenarios():
         try:
-            data = parse_scenario(scenario_dir)
+            data = parse_scenario(files)
             
-            out_file = OUT_DIR / f"{scenario_dir.name}.json"
+            out_file = OUT_DIR / f"{name}.json"
             
             with open(out_file, "w") as f:
                 json.dump(data, f, indent=2)
@@ -82,6 +142,6 @@ else:
             count += 1
             
         except Exception as e:
-            print(f"Skipping {scenario_dir.name}: {e}")
+            print(f"Skipping {name}: {e}")
 
     print(f"\nProcessing complete. {count} files saved to '{OUT_DIR}'")
\ No newline at end of file
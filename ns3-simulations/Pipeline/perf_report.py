@@ -0,0 +1,113 @@
+import sys
+import json
+from pathlib import Path
+from statistics import median
+
+from scenario_archive import ScenarioArchive
+
+# Compares the "perf" blocks the simulators write into config.json.
+# Each argument is a scenario directory tree or a scenario archive; runs are
+# grouped by the config keys given with --by (default: monitor; comma-separated,
+# dots reach into nested objects). --with adds config values other than perf
+# as columns, e.g. --with=routing.routes. For example
+#
+#   ./ns3 run "airport --firstScenario=50 --scenarios=3 --jobs=3 --monitor=all --archive=all.arc"
+#   ./ns3 run "airport --firstScenario=50 --scenarios=3 --jobs=3 --monitor=endpoints --archive=ep.arc"
+#   python perf_report.py all.arc ep.arc
+#
+# benchmark.py runs this comparison ("monitor") and records the table in
+# benchmarks/monitor.txt. Until that file exists no result has been measured:
+# the commands are how to measure, not evidence that either mode is faster.
+#
+# The same with --populateArp on one side and --by=populate_arp shows the
+# events and early loss (startup.*, one second after the apps start) that
+# pre-populated neighbour caches remove. benchmark.py records it for airport
+# and warehouse in benchmarks/populate_arp*.txt.
+#
+# Scenario 50 is the 200-camera airport topology. Routing setup at a fixed
+# camera count (stack_s + routing_s, their _rss_kb, and peak_rss_kb for nix):
+#
+#   for n in 200 1000 5000; do for r in global tree nix; do
+#     ./ns3 run "airport --scenarios=1 --cameras=$n --routing=$r --archive=routing-$n-$r.arc"
+#   done; done
+#   python perf_report.py --by=routing.mode,num_cameras --with=routing.routes routing-*.arc
+#
+# benchmark.py runs this as "routing" and records it in benchmarks/routing.txt,
+# including each size that failed and why. Until that file exists tree
+# routing's advantage over global SPF is only its lower asymptotic cost.
+
+METRICS = ["setup_s", "run_s", "events", "events_per_s", "rss_kb", "peak_rss_kb"]
+
+def lookup(config, path):
+    for part in path.split("."):
+        if not isinstance(config, dict) or part not in config:
+            return "unknown"
+        config = config[part]
+    return config
+
+def flatten(perf, prefix=""):
+    """{"startup": {"events": n}} -> {"startup.events": n}"""
+    flat = {}
+    for key, value in perf.items():
+        if isinstance(value, dict):
+            flat.update(flatten(value, f"{prefix}{key}."))
+        else:
+            flat[prefix + key] = value
+    return flat
+
+def configs(path):
+    path = Path(path)
+    if path.is_file():
+        with ScenarioArchive(path) as archive:
+            for scenario in archive.ids():
+                files = archive.get(scenario)
+                if "config.json" in files:
+                    yield json.loads(files["config.json"])
+        return
+
+    for config in sorted(path.glob("*/config.json")):
+        yield json.loads(config.read_text())
+
+def report(by, sources, extra=()):
+    """perf_report's table (lines) of the runs in sources, grouped by the --by
+    keys, with the numeric config values named in extra as further columns."""
+    groups = {}
+    for source in sources:
+        for config in configs(source):
+            # Served from the result cache: perf is that of an earlier run.
+            if "perf" not in config or config["perf"].get("cached"):
+                continue
+            key = "/".join(json.dumps(lookup(config, k), sort_keys=True).strip('"') for k in by.split(","))
+            perf = flatten(config["perf"])
+            for k in extra:
+                value = lookup(config, k)
+                if isinstance(value, (int, float)):
+                    perf[k] = value
+            groups.setdefault(key, []).append(perf)
+
+    first = METRICS + list(extra)
+    metrics = first + sorted({m for perfs in groups.values() for p in perfs for m in p} - set(first))
+    lines = [f"{by:<28}" + "".join(f"{m:>16}" for m in ["scenarios"] + metrics)]
+    for key, perfs in sorted(groups.items()):
+        row = [len(perfs)] + [median(p.get(m, 0) for p in perfs) for m in metrics]
+        lines.append(f"{key:<28}" + "".join(f"{v:>16.6g}" for v in row))
+    return lines
+
+def main(args):
+    by, extra = "monitor", []
+    while args and args[0].startswith(("--by=", "--with=")):
+        option, _, value = args.pop(0).partition("=")
+        if option == "--by":
+            by = value
+        else:
+            extra += value.split(",")
+    if not args:
+        print(f"usage: {sys.argv[0]} [--by=<config key>] [--with=<config key>] <outputs dir | archive>...")
+        return 1
+
+    for line in report(by, args, extra):
+        print(line)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
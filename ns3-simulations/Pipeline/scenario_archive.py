@@ -0,0 +1,66 @@
+import mmap
+import struct
+
+# Reader for the single-file scenario archives written by scenario-archive.h
+# (--archive=<path>). Any scenario is found with one lookup in the trailing
+# index of the mmapped file; only the requested scenario's files are read,
+# and they are returned as bytes, so they outlive the archive. Use it as a
+# context manager:
+#
+#   with ScenarioArchive(path) as archive:
+#       for scenario in archive.ids():
+#           files = archive.get(scenario)
+
+FOOTER_MAGIC = b"SCNAEND1"
+
+class ScenarioArchive:
+    def __init__(self, path):
+        self._file = open(path, "rb")
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+
+        index_offset, magic = struct.unpack_from("<Q8s", self._map, len(self._map) - 16)
+        if magic != FOOTER_MAGIC or self._map[index_offset:index_offset + 4] != b"SIDX":
+            raise ValueError(f"{path}: not a finalized scenario archive")
+        self.first, self.count = struct.unpack_from("<II", self._map, index_offset + 16)
+        self._index = index_offset + 24
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __len__(self):
+        return len(self.ids())
+
+    def ids(self):
+        return [s for s in range(self.first, self.first + self.count) if self._entry(s)]
+
+    def _entry(self, scenario):
+        i = scenario - self.first
+        if i < 0 or i >= self.count:
+            return None
+        offset, length = struct.unpack_from("<QQ", self._map, self._index + 16 * i)
+        return (offset, length) if length else None
+
+    def get(self, scenario):
+        """Return {file name: bytes} of one scenario, or None."""
+        entry = self._entry(scenario)
+        if entry is None:
+            return None
+        offset, length = entry
+        _, _, nfiles = struct.unpack_from("<4sII", self._map, offset)
+
+        files = {}
+        pos = offset + 24
+        for _ in range(nfiles):
+            name_len, data_len = struct.unpack_from("<I4xQ", self._map, pos)
+            name = self._map[pos + 16:pos + 16 + name_len].decode()
+            start = pos + 16 + name_len
+            files[name] = self._map[start:start + data_len]
+            pos = (start + data_len + 7) & ~7
+        return files
+
+    def close(self):
+        self._map.close()
+        self._file.close()
@@ -1,33 +1,81 @@
-import pandas as pd
 import os
-import numpy as np
 import json
+from pathlib import Path
+
+import numpy as np
+
+from columnar import read_columns
+from scenario_archive import ScenarioArchive
 
-IN = "dataset/parsed"
+# Cuts the per-flow time series the simulators write with --sampleStep
+# (timeseries.bin: per-flow deltas per sample window) into sliding windows of
+# SLICE seconds every STEP seconds. Both must be multiples of the sample step.
+#
+# One .npy per scenario and window, one row per flow active in it:
+#   flow_id, window start, tx_packets, rx_packets, tx_bytes, rx_bytes,
+#   lost_packets, mean delay (s), throughput (bit/s)
+#
+# The last window may be cut short by the end of the series; its throughput
+# is over the samples it actually covers.
+
+RAW_DIR = Path("outputs/airport2_scenarios")
+RAW_ARCHIVE = Path("outputs/airport2_scenarios.arc")  # used instead of RAW_DIR if present
 OUT = "dataset/slices"
 os.makedirs(OUT, exist_ok=True)
 
 SLICE = 1.0
 STEP  = 0.5
 
-for file in os.listdir(IN):
-    if file.endswith('.json'):
-        with open(f"{IN}/{file}", 'r') as f:
-            data = json.load(f)
+COUNTS = ["tx_packets", "rx_packets", "tx_bytes", "rx_bytes", "lost_packets", "delay_sum_ns"]
+
+def raw_scenarios():
+    """Yield (name, config, timeseries.bin bytes) for scenarios that have one."""
+    if RAW_ARCHIVE.exists():
+        with ScenarioArchive(RAW_ARCHIVE) as archive:
+            for scenario in archive.ids():
+                files = archive.get(scenario)
+                if "timeseries.bin" in files:
+                    yield f"scenario_{scenario:04d}", json.loads(files["config.json"]), files["timeseries.bin"]
+        return
+
+    for series in sorted(RAW_DIR.glob("*/timeseries.bin")):
+        yield series.parent.name, json.loads((series.parent / "config.json").read_text()), series.read_bytes()
+
+def windows(cols, sample):
+    """Yield (start, rows) per sliding window; rows as described above."""
+    # Sample index of every row: the row covers (end - sample, end].
+    index = np.rint(cols["time_ns"] / (sample * 1e9)).astype(np.int64) - 1
+    per_slice = int(round(SLICE / sample))
+    per_step = int(round(STEP / sample))
+    last = int(index.max()) if len(index) else -1
 
-        if 'nodes' in data:
-            df = pd.json_normalize(data['nodes'])
-            df['cumulative_time'] = df['frame_interval'].cumsum()
-        else:
+    for first in range(0, last + 1, per_step):
+        mask = (index >= first) & (index < first + per_slice)
+        if not mask.any():
             continue
+        flows, inverse = np.unique(cols["flow_id"][mask], return_inverse=True)
+        sums = {c: np.bincount(inverse, weights=cols[c][mask].astype(np.float64), minlength=len(flows))
+                for c in COUNTS}
+        rx = sums["rx_packets"]
+        delay = np.divide(sums["delay_sum_ns"] * 1e-9, rx, out=np.zeros_like(rx), where=rx > 0)
+        start = first * sample
+        length = (min(first + per_slice, last + 1) - first) * sample
+        yield start, np.column_stack([
+            flows, np.full(len(flows), start),
+            sums["tx_packets"], rx, sums["tx_bytes"], sums["rx_bytes"], sums["lost_packets"],
+            delay, sums["rx_bytes"] * 8 / length
+        ])
 
-        tmax = df['cumulative_time'].max()
-        print(f"Processing file: {file}, tmax: {tmax}")
-        start = 0
+for name, config, series in raw_scenarios():
+    sample = config.get("timeseries", {}).get("step_s")
+    if not sample or abs(SLICE / sample - round(SLICE / sample)) > 1e-9 or \
+            abs(STEP / sample - round(STEP / sample)) > 1e-9:
+        print(f"Skipping {name}: sample step {sample} does not divide {SLICE}/{STEP}")
+        continue
 
-        while start < tmax:
-            window = df[(df['cumulative_time'] >= start) & (df['cumulative_time'] < start + SLICE)]
-            print(f"Start: {start}, Window size: {len(window)}")
-            if not window.empty:
-                np.save(f"{OUT}/{file}_{start:.1f}.npy", window.to_numpy())
-            start += STEP
+    cols = read_columns(series)
+    count = 0
+    for start, rows in windows(cols, sample):
+        np.save(f"{OUT}/{name}_{start:.1f}.npy", rows)
+        count += 1
+    print(f"Processing {name}: {len(cols['time_ns'])} samples, {count} windows")
@@ -0,0 +1,70 @@
+#ifndef ADDRESS_PLAN_H
+#define ADDRESS_PLAN_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/* ================= HIERARCHICAL ADDRESS PLAN ================= */
+// Every BSS and every group of point-to-point links gets its own prefix, so
+// a whole subtree can be reached through one route. The second octet is the
+// tier of the node that owns the block (stations are tier 0, APs tier 1):
+//
+//   10.1.0.0/16      one block per BSS, sized for its stations; the AP
+//                    gets the first host address
+//   10.<t>.<g>.0/24  consecutive /30s of the links between node g of tier
+//                    t >= 2 and the tier below it
+//
+// Blocks are handed out by index, so the plan does not depend on the order
+// in which links were created.
+
+struct Subnet {
+    Ipv4Address network;
+    uint32_t prefixLength;
+
+    Ipv4Mask Mask() const { return Ipv4Mask(("/" + std::to_string(prefixLength)).c_str()); }
+};
+
+inline Subnet BssSubnet(uint32_t bss, uint32_t maxStations) {
+    uint32_t len = 30;
+    while (len > 16 && (1u << (32 - len)) < maxStations + 3) len--;    // + AP, network, broadcast
+    NS_ABORT_MSG_IF((uint64_t)(bss + 1) << (32 - len) > (1u << 16),
+                    "BSS " << bss << " does not fit into 10.1.0.0/16");
+    return {Ipv4Address(0x0a010000u + (bss << (32 - len))), len};
+}
+
+inline Subnet LinkGroupSubnet(uint32_t tier, uint32_t owner) {
+    NS_ABORT_MSG_IF(tier < 2 || tier > 255 || owner > 255, "No /24 for node " << owner << " of tier " << tier);
+    return {Ipv4Address(0x0a000000u | (tier << 16) | (owner << 8)), 24};
+}
+
+// Aggregate of all blocks owned by one tier.
+inline Subnet TierSupernet(uint32_t tier) {
+    return {Ipv4Address(0x0a000000u | (tier << 16)), 16};
+}
+
+inline void AssignBss(const Subnet& s, const NetDeviceContainer& ap, const NetDeviceContainer& stations) {
+    Ipv4AddressHelper h;
+    h.SetBase(s.network, s.Mask());
+    h.Assign(ap);
+    h.Assign(stations);
+}
+
+inline void AssignLinks(const Subnet& s, const std::vector<NetDeviceContainer>& links) {
+    NS_ABORT_MSG_IF(links.size() > 64, "More than 64 /30 links in " << s.network << "/24");
+    Ipv4AddressHelper h;
+    h.SetBase(s.network, Ipv4Mask("255.255.255.252"));
+    for (auto& l : links) {
+        h.Assign(l);
+        h.NewNetwork();
+    }
+}
+
+} // namespace ns3
+
+#endif // ADDRESS_PLAN_H
@@ -6,14 +6,36 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
+#include "ns3/nix-vector-routing-module.h"
 
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <memory>
 #include <vector>
+#include <set>
 #include <random>
+#include <cmath>
+#include <filesystem>
 #include <nlohmann/json.hpp>
 
+#include "sweep-executor.h"
+#include "flow-stats-writer.h"
+#include "camera-flow-join.h"
+#include "output-writer.h"
+#include "static-propagation.h"
+#include "pruned-spectrum-channel.h"
+#include "sim-perf.h"
+#include "tree-routing.h"
+#include "address-plan.h"
+#include "channel-plan.h"
+#include "camera-apps.h"
+#include "inference-server.h"
+#include "flow-sketch.h"
+#include "flow-timeseries.h"
+#include "queue-trace.h"
+#include "link-utilization.h"
+
 using namespace ns3;
 using json = nlohmann::json;
 
@@ -43,6 +65,14 @@ double GetInferenceDelay(const std::string& model, std::mt19937 &gen) {
     return std::max(0.001, dist(gen));
 }
 
+// Marginal cost of one more frame in an inference batch, relative to one
+// frame alone: larger models saturate the accelerator sooner.
+double GetBatchScaling(const std::string& model) {
+    if (model == "small") return 0.1;
+    if (model == "medium") return 0.2;
+    return 0.35; // heavy
+}
+
 uint32_t GetResultSize(const std::string& model, std::mt19937 &gen) {
     uint32_t base;
     if (model == "small") base = 200;
@@ -71,165 +101,710 @@ double GetFrameInterval(const std::string& processing, std::mt19937 &gen) {
     return std::max(0.01, dist(gen));
 }
 
-// ================= MAIN =================
-int main(int argc, char *argv[]) {
-    Time::SetResolution(Time::NS);
-    LogComponentEnable("AirportSimulation", LOG_LEVEL_INFO);
+// Every scenario gets its own generator derived from (seed, run), so any
+// scenario index can be generated alone, in any order or process, and still
+// draw exactly the same camera parameters.
+std::mt19937 ScenarioGenerator(uint32_t seed, uint64_t run) {
+    std::seed_seq seq{seed, (uint32_t)(run & 0xffffffff), (uint32_t)(run >> 32)};
+    return std::mt19937(seq);
+}
 
-    uint32_t scenarioCount = 100; // default
-    CommandLine cmd;
-    cmd.AddValue("scenarios", "Number of scenarios to simulate", scenarioCount);
-    cmd.Parse(argc, argv);
+// Access points on a square grid, kApSpacing apart, with every camera on a
+// small spiral around its access point (camera i uses AP i % numAccessNodes).
+// Wired nodes stay at the origin; only Wi-Fi positions matter.
+const double kApSpacing = 100.0; // metres
+
+Vector TerminalApPosition(uint32_t ap, uint32_t numAccessNodes) {
+    uint32_t cols = (uint32_t)std::ceil(std::sqrt((double)numAccessNodes));
+    return Vector((ap % cols) * kApSpacing, (ap / cols) * kApSpacing, 0.0);
+}
+
+Vector TerminalCameraPosition(uint32_t cam, uint32_t numAccessNodes) {
+    uint32_t k = cam / numAccessNodes;             // k-th camera of its AP
+    double angle = k * 2.39996;                    // golden angle
+    double radius = 5.0 + 5.0 * (k % 6);
+    Vector ap = TerminalApPosition(cam % numAccessNodes, numAccessNodes);
+    return Vector(ap.x + radius*std::cos(angle), ap.y + radius*std::sin(angle), 0.0);
+}
+
+Ptr<ListPositionAllocator> TerminalLayout(uint32_t numCameras, uint32_t numAccessNodes, uint32_t numWired) {
+    Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
+    for (uint32_t i=0;i<numCameras;i++) pos->Add(TerminalCameraPosition(i, numAccessNodes));
+    for (uint32_t j=0;j<numAccessNodes;j++) pos->Add(TerminalApPosition(j, numAccessNodes));
+    for (uint32_t j=0;j<numWired;j++) pos->Add(Vector(0.0, 0.0, 0.0));
+    return pos;
+}
+
+std::string ScenarioDir(uint32_t scenario) {
+    std::ostringstream dir;
+    dir << "outputs/airport_scenarios/scenario_" << std::setw(4) << std::setfill('0') << scenario;
+    return dir.str();
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+// ================= SCENARIO =================
+struct ScenarioOptions {
+    uint32_t seed;        // ns-3 RngSeed, shared by the whole sweep
+    uint64_t baseRun;     // RngRun of scenario 0; scenario N uses baseRun + N
+    std::string flowFormat; // xml / columnar / both
+    std::string archive;    // scenario archive path; empty = one directory per scenario
+    bool flowSketch;        // per-flow delay/jitter sketches (flow_sketch.bin, flow_tails.bin)
+    double sketchAlpha;     // relative accuracy of the sketches
+    double sampleStep;      // flow time series step (s, timeseries.bin); 0 = off
+    double queueStep;       // queue occupancy log step (s, network_log.csv); 0 = off
+    double linkStep;        // link/BSS utilization step (s, link_util.bin, link_report.json); 0 = off
+    uint32_t hotLinks;      // links in the report that list their flows
+    bool staticChannel;     // serve Wi-Fi loss/delay from a precomputed table
+    std::string channel;    // yans / pruned
+    double interferenceRange; // metres, pruned channel only
+    std::string layout;     // origin / terminal
+    std::string bss;        // shared / perAp
+    std::string channelPlan; // unique / 2.4 / 5 / dual, perAp only
+    std::string cameraApp;  // onoff / frames
+    std::string inference;  // open / server, server needs frames
+    uint32_t computeSlots;  // per InferenceServer
+    uint32_t queueLimit;    // frames waiting per InferenceServer, 0 = unbounded
+    uint32_t batchMax;      // frames per inference batch
+    double batchWait;       // seconds a partial batch may wait to fill
+    std::string monitor;    // all / endpoints
+    std::string routing;    // global / tree / nix
+    std::string addressing; // flat / hier
+    bool populateArp;       // fill neighbour caches before the run
+    bool fastAssociate;     // ad hoc Wi-Fi, camera bound to its accessId AP by routing
+    uint32_t cameras;       // camera count override, 0 = per-scenario default
+};
+
+int RunScenario(uint32_t scenario, const ScenarioOptions& opts, AsyncOutputWriter& writer) {
+    ScenarioPerf perf;
+
+    // ns-3 substream and camera-parameter stream are both keyed by the run
+    // number, never by what earlier scenarios consumed.
+    uint64_t run = opts.baseRun + scenario;
+    RngSeedManager::SetSeed(opts.seed);
+    RngSeedManager::SetRun(run);
+    RngSeedManager::ResetNextStreamIndex();
+
+    std::mt19937 gen = ScenarioGenerator(opts.seed, run);
     std::uniform_int_distribution<int> procDist(0, 3); // processing location
 
-    for (uint32_t scenario = 0; scenario < scenarioCount; scenario++) {
-        NS_LOG_INFO("Running scenario " << scenario);
-
-        // ===== PARAMETERS PER SCENARIO =====
-        uint32_t numCameras     = 150 + scenario % 51; // 150–200 cameras
-        uint32_t numAccessNodes = 10 + scenario % 6;   // 10–15
-        uint32_t numAggNodes    = 4 + scenario % 3;    // 4–6
-        uint32_t numCoreNodes   = 2;                   // fixed
-        uint32_t numCloudNodes  = 1;                   // fixed
-
-        // ===== NODE CREATION =====
-        NodeContainer cameras, accessNodes, aggNodes, coreNodes, cloud;
-        cameras.Create(numCameras);
-        accessNodes.Create(numAccessNodes);
-        aggNodes.Create(numAggNodes);
-        coreNodes.Create(numCoreNodes);
-        cloud.Create(numCloudNodes);
-
-        NodeContainer allNodes;
-        allNodes.Add(cameras);
-        allNodes.Add(accessNodes);
-        allNodes.Add(aggNodes);
-        allNodes.Add(coreNodes);
-        allNodes.Add(cloud);
-
-        // ===== WIFI CAM → ACCESS =====
-        WifiHelper wifi; wifi.SetStandard(WIFI_STANDARD_80211n);
-        YansWifiPhyHelper phy; YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-        phy.SetChannel(channel.Create());
-        WifiMacHelper mac; Ssid ssid("airport-net");
-        mac.SetType("ns3::StaWifiMac","Ssid",SsidValue(ssid));
-        NetDeviceContainer camDevs = wifi.Install(phy, mac, cameras);
-        mac.SetType("ns3::ApWifiMac","Ssid",SsidValue(ssid));
-        NetDeviceContainer accessDevs = wifi.Install(phy, mac, accessNodes);
-
-        // ===== P2P LINKS =====
-        PointToPointHelper p2p; 
-        p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
-        p2p.SetChannelAttribute("Delay", StringValue("5ms"));
-
-        NetDeviceContainer aggDevs, coreDevs, cloudDevs;
-        for (uint32_t i=0;i<numAccessNodes;i++)
-            for (uint32_t j=0;j<numAggNodes;j++)
-                aggDevs.Add(p2p.Install(accessNodes.Get(i), aggNodes.Get(j)));
-        for (uint32_t i=0;i<numAggNodes;i++)
-            for (uint32_t j=0;j<numCoreNodes;j++)
-                coreDevs.Add(p2p.Install(aggNodes.Get(i), coreNodes.Get(j)));
-        for (uint32_t i=0;i<numCoreNodes;i++)
-            cloudDevs.Add(p2p.Install(coreNodes.Get(i), cloud.Get(0)));
-
-        // ===== INTERNET STACK =====
-        InternetStackHelper stack; stack.Install(allNodes);
+    NS_LOG_INFO("Running scenario " << scenario);
+
+    // ===== PARAMETERS PER SCENARIO =====
+    uint32_t numCameras     = opts.cameras ? opts.cameras : 150 + scenario % 51; // 150–200 cameras
+    uint32_t numAccessNodes = 10 + scenario % 6;   // 10–15
+    uint32_t numAggNodes    = 4 + scenario % 3;    // 4–6
+    uint32_t numCoreNodes   = 2;                   // fixed
+    uint32_t numCloudNodes  = 1;                   // fixed
+
+    // ===== NODE CREATION =====
+    NodeContainer cameras, accessNodes, aggNodes, coreNodes, cloud;
+    cameras.Create(numCameras);
+    accessNodes.Create(numAccessNodes);
+    aggNodes.Create(numAggNodes);
+    coreNodes.Create(numCoreNodes);
+    cloud.Create(numCloudNodes);
+
+    NodeContainer allNodes;
+    allNodes.Add(cameras);
+    allNodes.Add(accessNodes);
+    allNodes.Add(aggNodes);
+    allNodes.Add(coreNodes);
+    allNodes.Add(cloud);
+
+    // ===== WIFI CAM → ACCESS =====
+    // shared: one SSID and one channel object for every camera and AP.
+    // perAp: BSS j (AP j and the cameras with accessId j) gets its own SSID
+    // and channel object, so BSSes neither contend nor interfere. Each
+    // medium (channel object) may carry several BSSes.
+    uint32_t numBss = opts.bss=="perAp" ? numAccessNodes : 1;
+    std::vector<uint32_t> mediumOf(numBss);
+    for (uint32_t b=0;b<numBss;b++) mediumOf[b] = b;
+    uint32_t numMedia = numBss;
+
+    // Planned channels: BSSes are coloured with the real channels of the
+    // chosen bands, and all BSSes on one channel share one medium. Positions
+    // are those the mobility section installs below.
+    ChannelPlan plan; std::vector<uint32_t> mediumChannel;
+    if (opts.channelPlan!="unique"){
+        auto position = [&](bool ap, uint32_t i){
+            if (opts.layout!="terminal") return Vector(0.0, 0.0, 0.0);
+            return ap ? TerminalApPosition(i, numAccessNodes) : TerminalCameraPosition(i, numAccessNodes);
+        };
+        std::vector<std::vector<Vector>> members(numBss);
+        for (uint32_t j=0;j<numAccessNodes;j++) members[j].push_back(position(true, j));
+        for (uint32_t i=0;i<numCameras;i++) members[i % numAccessNodes].push_back(position(false, i));
+        double range = InterferenceRange(CreateObject<LogDistancePropagationLossModel>(), kWifiTxPowerDbm, kWifiCcaDbm);
+        if (opts.channel=="pruned") range = std::min(range, opts.interferenceRange);
+        plan = PlanChannels(members, range, AvailableChannels(opts.channelPlan));
+        mediumChannel = plan.Used(mediumOf);
+        numMedia = mediumChannel.size();
+    }
+
+    WifiHelper wifi; wifi.SetStandard(WIFI_STANDARD_80211n);
+    YansWifiPhyHelper yansPhy; SpectrumWifiPhyHelper spectrumPhy;
+    std::vector<Ptr<YansWifiChannel>> yansChannels;
+    std::vector<Ptr<StaticPropagationTable>> propagation(numMedia);
+    std::vector<Ptr<RangePrunedSpectrumChannel>> pruned;
+    for (uint32_t m=0;m<numMedia;m++){
+        if (opts.channel=="pruned")
+            pruned.push_back(CreatePrunedSpectrumChannel(opts.interferenceRange, opts.staticChannel ? &propagation[m] : nullptr));
+        else if (opts.staticChannel) yansChannels.push_back(CreateStaticYansChannel(propagation[m]));
+        else yansChannels.push_back(YansWifiChannelHelper::Default().Create());
+    }
+    const WifiPhyHelper& phy = opts.channel=="pruned" ? static_cast<const WifiPhyHelper&>(spectrumPhy)
+                                                      : static_cast<const WifiPhyHelper&>(yansPhy);
+
+    // fastAssociate: ns-3 cannot start a StaWifiMac associated, so cameras and
+    // APs run ad hoc MACs (no beacons, probes or association) and each camera
+    // reaches its accessId AP through its routes instead.
+    std::vector<Ptr<NetDevice>> camDev(numCameras), accessDev(numAccessNodes);
+    std::vector<NetDeviceContainer> bssDevs(numBss);
+    std::vector<NodeContainer> mediumNodes(numMedia);
+    for (uint32_t b=0;b<numBss;b++){
+        if (opts.channel=="pruned") spectrumPhy.SetChannel(pruned[mediumOf[b]]);
+        else yansPhy.SetChannel(yansChannels[mediumOf[b]]);
+        if (!mediumChannel.empty()){
+            StringValue settings(plan.channels[mediumChannel[mediumOf[b]]].Settings());
+            yansPhy.Set("ChannelSettings", settings); spectrumPhy.Set("ChannelSettings", settings);
+        }
+
+        std::vector<uint32_t> camIds, apIds;
+        for (uint32_t i=0;i<numCameras;i++) if (numBss==1 || i % numAccessNodes == b) camIds.push_back(i);
+        for (uint32_t j=0;j<numAccessNodes;j++) if (numBss==1 || j == b) apIds.push_back(j);
+        NodeContainer bssCams, bssAps;
+        for (uint32_t i:camIds) bssCams.Add(cameras.Get(i));
+        for (uint32_t j:apIds) bssAps.Add(accessNodes.Get(j));
+        mediumNodes[mediumOf[b]].Add(bssCams); mediumNodes[mediumOf[b]].Add(bssAps);
+
+        WifiMacHelper mac; Ssid ssid(numBss==1 ? "airport-net" : "airport-net-" + std::to_string(b));
+        if (opts.fastAssociate) mac.SetType("ns3::AdhocWifiMac");
+        else mac.SetType("ns3::StaWifiMac","Ssid",SsidValue(ssid));
+        NetDeviceContainer devs = wifi.Install(phy, mac, bssCams);
+        for (uint32_t k=0;k<camIds.size();k++) camDev[camIds[k]] = devs.Get(k);
+        bssDevs[b].Add(devs);
+        if (!opts.fastAssociate) mac.SetType("ns3::ApWifiMac","Ssid",SsidValue(ssid));
+        devs = wifi.Install(phy, mac, bssAps);
+        for (uint32_t k=0;k<apIds.size();k++) accessDev[apIds[k]] = devs.Get(k);
+        bssDevs[b].Add(devs);
+    }
+    NetDeviceContainer camDevs, accessDevs;
+    for (auto &d:camDev) camDevs.Add(d);
+    for (auto &d:accessDev) accessDevs.Add(d);
+
+    // ===== P2P LINKS =====
+    PointToPointHelper p2p; 
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("5ms"));
+
+    // Links are also kept grouped by their upper node for hierarchical addressing.
+    NetDeviceContainer aggDevs, coreDevs, cloudDevs;
+    std::vector<std::vector<NetDeviceContainer>> aggLinks(numAggNodes), coreLinks(numCoreNodes), cloudLinks(1);
+    for (uint32_t i=0;i<numAccessNodes;i++)
+        for (uint32_t j=0;j<numAggNodes;j++){
+            NetDeviceContainer l = p2p.Install(accessNodes.Get(i), aggNodes.Get(j));
+            aggDevs.Add(l); aggLinks[j].push_back(l);
+        }
+    for (uint32_t i=0;i<numAggNodes;i++)
+        for (uint32_t j=0;j<numCoreNodes;j++){
+            NetDeviceContainer l = p2p.Install(aggNodes.Get(i), coreNodes.Get(j));
+            coreDevs.Add(l); coreLinks[j].push_back(l);
+        }
+    for (uint32_t i=0;i<numCoreNodes;i++){
+        NetDeviceContainer l = p2p.Install(coreNodes.Get(i), cloud.Get(0));
+        cloudDevs.Add(l); cloudLinks[0].push_back(l);
+    }
+
+    // ===== INTERNET STACK =====
+    InternetStackHelper stack; Ipv4NixVectorHelper nix;
+    if (opts.routing=="nix") stack.SetRoutingHelper(nix);
+    perf.Measure("stack", [&]{ stack.Install(allNodes); });
+    // hier, perAp: BSS j holds AP j and the cameras with accessId j. shared:
+    // one SSID, so a camera may associate with any AP; all of them share a
+    // single block, and every AP owns it.
+    uint32_t perBss = (numCameras + numAccessNodes - 1) / numAccessNodes;
+    auto bssSubnet = [&](uint32_t j){
+        return numBss==1 ? BssSubnet(0, numCameras + numAccessNodes) : BssSubnet(j, perBss);
+    };
+    if (opts.addressing=="hier"){
+        if (numBss==1) AssignBss(bssSubnet(0), accessDevs, camDevs);
+        else for (uint32_t j=0;j<numAccessNodes;j++){
+            NetDeviceContainer stations;
+            for (uint32_t i=j;i<numCameras;i+=numAccessNodes) stations.Add(camDevs.Get(i));
+            AssignBss(bssSubnet(j), NetDeviceContainer(accessDevs.Get(j)), stations);
+        }
+        for (uint32_t j=0;j<numAggNodes;j++) AssignLinks(LinkGroupSubnet(2, j), aggLinks[j]);
+        for (uint32_t j=0;j<numCoreNodes;j++) AssignLinks(LinkGroupSubnet(3, j), coreLinks[j]);
+        AssignLinks(LinkGroupSubnet(4, 0), cloudLinks[0]);
+    }
+    else {
         Ipv4AddressHelper addr; addr.SetBase("10.0.0.0","255.255.0.0");
         addr.Assign(camDevs); addr.Assign(accessDevs); addr.Assign(aggDevs); addr.Assign(coreDevs); addr.Assign(cloudDevs);
-        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
-
-        // ===== MOBILITY =====
-        MobilityHelper mob; mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-        mob.Install(allNodes);
-
-        // ===== CAMERA CONFIGS =====
-        std::vector<CameraConfig> configs;
-        std::vector<std::string> models = {"small","medium","heavy"};
-        std::vector<std::string> procs = {"camera","access","aggregation","core"};
-
-        for (uint32_t i=0;i<numCameras;i++){
-            std::string model = models[i % 3];
-            std::string proc = procs[procDist(gen)];
-            configs.push_back({
-                i,
-                i % numAccessNodes,
-                i % numAggNodes,
-                i % numCoreNodes,
-                proc,
-                model,
-                GetFrameSize(model, gen),
-                GetFrameInterval(proc, gen),
-                GetInferenceDelay(model, gen),
-                GetResultSize(model, gen)
-            });
+    }
+
+    // ===== ROUTING =====
+    // tree: routes straight from the tier structure instead of global SPF.
+    // Flat addresses get host routes towards every non-camera node (cameras
+    // only ever source traffic); hierarchical ones get aggregated prefixes.
+    // nix: nothing to do here, paths are computed on first use and cached per
+    // node, so their cost shows up in run time and peak RSS instead.
+    perf.Measure("routing", [&]{
+        if (opts.routing=="tree"){
+            TreeRoutingHelper tree;
+            tree.AddTier(cameras); tree.AddTier(accessNodes); tree.AddTier(aggNodes);
+            tree.AddTier(coreNodes); tree.AddTier(cloud);
+            tree.SetLeafParent([numAccessNodes](uint32_t cam){ return cam % numAccessNodes; });
+            if (opts.addressing=="hier"){
+                for (uint32_t j=0;j<numAccessNodes;j++){
+                    Subnet s = bssSubnet(j);
+                    tree.AddPrefix(accessNodes.Get(j), s.network, s.Mask());
+                }
+                std::vector<NodeContainer> owners = {aggNodes, coreNodes, cloud};
+                for (uint32_t t=2;t<=4;t++){
+                    for (uint32_t j=0;j<owners[t-2].GetN();j++){
+                        Subnet s = LinkGroupSubnet(t, j);
+                        tree.AddPrefix(owners[t-2].Get(j), s.network, s.Mask());
+                    }
+                    Subnet all = TierSupernet(t);
+                    tree.SetTierAggregate(t, all.network, all.Mask());
+                }
+                Subnet bss = TierSupernet(1);
+                tree.SetTierAggregate(1, bss.network, bss.Mask());
+                tree.PopulateAggregated();
+            }
+            else {
+                tree.AddDestinations(NodeContainer(accessNodes, aggNodes, coreNodes, cloud));
+                tree.Populate();
+            }
         }
+        else if (opts.routing=="global") Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
-        // ===== FRAME FLOWS =====
-        for (auto &c:configs){
-            Ptr<Node> dst =
-                (c.processing=="camera") ? cameras.Get(c.id) :
-                (c.processing=="access") ? accessNodes.Get(c.accessId) :
-                (c.processing=="aggregation") ? aggNodes.Get(c.aggregationId) :
-                                               coreNodes.Get(c.coreId);
-
-            OnOffHelper src("ns3::UdpSocketFactory",
-                InetSocketAddress(dst->GetObject<Ipv4>()->GetAddress(1,0).GetLocal(),9000+c.id));
-            src.SetConstantRate(DataRate(c.frameSize*8 / c.frameInterval),c.frameSize);
-            auto app = src.Install(cameras.Get(c.id));
-            app.Start(Seconds(1.0));
-            app.Stop(Seconds(20.0));
+        // Tree routes already go through the parent AP; global routing would
+        // pick any AP on the shared medium.
+        if (opts.fastAssociate && opts.routing=="global")
+            SetLeafGateways(cameras, accessNodes, [numAccessNodes](uint32_t cam){ return cam % numAccessNodes; },
+                            NodeContainer(accessNodes, aggNodes, coreNodes, cloud));
+    });
+    uint64_t routes = CountRoutes(allNodes);
+
+    // Every on-link neighbour is known from the address plan, so no camera
+    // needs to ARP when the applications start.
+    if (opts.populateArp)
+        perf.Measure("arp", []{ NeighborCacheHelper().PopulateNeighborCache(); });
+
+    // ===== MOBILITY =====
+    MobilityHelper mob; mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    if (opts.layout=="terminal")
+        mob.SetPositionAllocator(TerminalLayout(numCameras, numAccessNodes, numAggNodes+numCoreNodes+numCloudNodes));
+    mob.Install(allNodes);
+    for (uint32_t m=0;m<numMedia;m++) // positions are final
+        if (propagation[m]) propagation[m]->Precompute(mediumNodes[m]);
+
+    // ===== CAMERA CONFIGS =====
+    std::vector<CameraConfig> configs;
+    std::vector<std::string> models = {"small","medium","heavy"};
+    std::vector<std::string> procs = {"camera","access","aggregation","core"};
+
+    for (uint32_t i=0;i<numCameras;i++){
+        std::string model = models[i % 3];
+        std::string proc = procs[procDist(gen)];
+        configs.push_back({
+            i,
+            i % numAccessNodes,
+            i % numAggNodes,
+            i % numCoreNodes,
+            proc,
+            model,
+            GetFrameSize(model, gen),
+            GetFrameInterval(proc, gen),
+            GetInferenceDelay(model, gen),
+            GetResultSize(model, gen)
+        });
+    }
+
+    auto procNodeOf = [&](const CameraConfig& c) -> Ptr<Node> {
+        return (c.processing=="camera") ? cameras.Get(c.id) :
+               (c.processing=="access") ? accessNodes.Get(c.accessId) :
+               (c.processing=="aggregation") ? aggNodes.Get(c.aggregationId) :
+                                              coreNodes.Get(c.coreId);
+    };
+
+    // ===== FRAME FLOWS =====
+    // frames: one burst of MTU-sized fragments per frame interval, received
+    // by a FrameSinkApp that measures per-frame latency.
+    // server: the processing node's InferenceServer receives the frames and
+    // sends one result per processed frame instead of the open-loop flow.
+    std::vector<Ptr<FrameSinkApp>> frameSinks(numCameras);
+    InferenceServers servers(opts.computeSlots, opts.queueLimit, opts.batchMax, Seconds(opts.batchWait),
+                             Seconds(1.0), Seconds(20.0));
+    Ptr<ResultSinkApp> resultSink;
+    if (opts.inference=="server"){
+        resultSink = CreateObject<ResultSinkApp>();
+        cloud.Get(0)->AddApplication(resultSink);
+    }
+    for (auto &c:configs){
+        Ptr<Node> dst = procNodeOf(c);
+        if (opts.inference=="server"){
+            InstallCameraFrameApp(cameras.Get(c.id), c.id, InetSocketAddress(PrimaryAddress(dst),kFramePortBase+c.id),
+                                  c.frameSize, Seconds(c.frameInterval), Seconds(1.0), Seconds(20.0));
+            servers.On(dst, c.processing!="camera")->AddCamera(c.id, kFramePortBase+c.id, c.model, Seconds(c.inferenceDelay),
+                GetBatchScaling(c.model), c.resultSize, InetSocketAddress(PrimaryAddress(cloud.Get(0)),kResultPortBase+c.id));
+            resultSink->AddCamera(c.id, kResultPortBase+c.id);
+            continue;
+        }
+        if (opts.cameraApp=="frames"){
+            frameSinks[c.id] = InstallFrameFlow(cameras.Get(c.id), c.id, dst, PrimaryAddress(dst), kFramePortBase+c.id,
+                                                c.frameSize, Seconds(c.frameInterval), Seconds(1.0), Seconds(20.0));
+            continue;
         }
 
-        // ===== RESULT FLOWS =====
+        OnOffHelper src("ns3::UdpSocketFactory",
+            InetSocketAddress(PrimaryAddress(dst),kFramePortBase+c.id));
+        src.SetConstantRate(DataRate(c.frameSize*8 / c.frameInterval),c.frameSize);
+        auto app = src.Install(cameras.Get(c.id));
+        app.Start(Seconds(1.0));
+        app.Stop(Seconds(20.0));
+    }
+
+    // ===== RESULT FLOWS =====
+    if (opts.inference=="open")
         for (auto &c:configs){
-            Ptr<Node> procNode =
-                (c.processing=="camera") ? cameras.Get(c.id) :
-                (c.processing=="access") ? accessNodes.Get(c.accessId) :
-                (c.processing=="aggregation") ? aggNodes.Get(c.aggregationId) :
-                                               coreNodes.Get(c.coreId);
+            Ptr<Node> procNode = procNodeOf(c);
 
             OnOffHelper res("ns3::UdpSocketFactory",
-                InetSocketAddress(cloud.Get(0)->GetObject<Ipv4>()->GetAddress(1,0).GetLocal(),10000+c.id));
+                InetSocketAddress(PrimaryAddress(cloud.Get(0)),kResultPortBase+c.id));
             res.SetConstantRate(DataRate(c.resultSize*8 / 0.5), c.resultSize);
             auto app = res.Install(procNode);
             app.Start(Seconds(1.0+c.inferenceDelay));
             app.Stop(Seconds(20.0));
         }
 
-        // ===== FLOW MONITOR =====
-        FlowMonitorHelper fm;
-        Ptr<FlowMonitor> monitor = fm.InstallAll();
-        Simulator::Stop(Seconds(22.0));
-        Simulator::Run();
-
-        // ===== OUTPUT =====
-        std::ostringstream dir;
-        dir << "outputs/airport_scenarios/scenario_" << std::setw(4) << std::setfill('0') << scenario;
-        system(("mkdir -p "+dir.str()).c_str());
-
-        monitor->SerializeToXmlFile(dir.str()+"/flow.xml", true,true);
-        json meta;
-        meta["scenario"]=scenario;
-        meta["cameras"]=json::array();
-        for (auto &c:configs)
-            meta["cameras"].push_back({
-                {"id",c.id},
-                {"processing",c.processing},
-                {"model",c.model},
-                {"frame_size",c.frameSize},
-                {"frame_interval",c.frameInterval},
-                {"inference_delay",c.inferenceDelay},
-                {"result_size",c.resultSize}
-            });
-        std::ofstream cfg(dir.str()+"/config.json");
-        cfg << meta.dump(4); cfg.close();
-
-        Simulator::Destroy();
-    }
-
-    NS_LOG_INFO("All scenarios completed.");
+    // ===== FLOW MONITOR =====
+    // Endpoints = cameras, processing nodes and the sink: flows are still
+    // classified at both ends, but forwarding hops carry no probes.
+    FlowMonitorHelper fm;
+    Ptr<FlowMonitor> monitor;
+    if (opts.monitor=="endpoints"){
+        NodeContainer endpoints; std::set<uint32_t> seen;
+        auto addEndpoint = [&](Ptr<Node> n){ if (seen.insert(n->GetId()).second) endpoints.Add(n); };
+        for (auto &c:configs){ addEndpoint(cameras.Get(c.id)); addEndpoint(procNodeOf(c)); }
+        addEndpoint(cloud.Get(0));
+        monitor = fm.Install(endpoints);
+    }
+    else monitor = fm.InstallAll();
+
+    // Only sources and destinations fire these traces, so all nodes is cheap.
+    FlowSketchMonitor sketches(opts.sketchAlpha);
+    if (opts.flowSketch) sketches.Install(allNodes);
+
+    FlowTimeSampler sampler(Seconds(opts.sampleStep));
+    if (opts.sampleStep > 0) sampler.Start(monitor, Seconds(22.0));
+
+    QueueTracer queues(Seconds(opts.queueStep));
+    if (opts.queueStep > 0) queues.Install(allNodes, Seconds(22.0));
+
+    LinkUtilization links(Seconds(opts.linkStep));
+    if (opts.linkStep > 0){
+        for (uint32_t b=0;b<numBss;b++) links.AddBss(numBss==1 ? "wifi" : "bss" + std::to_string(b), bssDevs[b]);
+        links.Install(allNodes, Seconds(22.0), NodeLabels({{"camera",cameras},{"access",accessNodes},
+                                                           {"agg",aggNodes},{"core",coreNodes},{"cloud",cloud}}));
+    }
+
+    Simulator::Stop(Seconds(22.0));
+    perf.SnapshotAt(Seconds(2.0), monitor); // one second after the apps start
+    perf.RunStarted();
+    Simulator::Run();
+    perf.RunFinished();
+    sampler.Finish();
+    queues.Finish();
+    links.Finish();
+
+    // ===== OUTPUT =====
+    // Snapshot everything that needs ns-3; formatting and I/O run on the
+    // writer thread while the next scenario is being built.
+    std::string dir = ScenarioDir(scenario);
+    auto rows = std::make_shared<const std::vector<FlowRow>>(
+        CollectFlowRows(monitor, DynamicCast<Ipv4FlowClassifier>(fm.GetClassifier())));
+
+    ScenarioOutput out;
+    out.scenario = scenario;
+    out.dir = dir;
+    if (opts.flowFormat != "columnar") {
+        std::string xml = "<?xml version=\"1.0\" ?>\n" + monitor->SerializeToXmlString(0, true,true);
+        out.files.push_back({"flow.xml", [xml]{ return xml; }});
+    }
+    if (opts.flowFormat != "xml")
+        out.files.push_back({"flow.bin", [rows]{ return EncodeFlowColumns(*rows).Encode(); }});
+    if (opts.flowSketch) {
+        ColumnarTable buckets = sketches.EncodeBuckets(*rows), tails = sketches.EncodeTails(*rows);
+        out.files.push_back({"flow_sketch.bin", [buckets]{ return buckets.Encode(); }});
+        out.files.push_back({"flow_tails.bin", [tails]{ return tails.Encode(); }});
+    }
+    if (opts.sampleStep > 0) {
+        ColumnarTable series = sampler.Table();
+        out.files.push_back({"timeseries.bin", [series]{ return series.Encode(); }});
+    }
+    if (opts.queueStep > 0) {
+        auto samples = std::make_shared<const std::vector<QueueSample>>(queues.Snapshot());
+        out.files.push_back({"network_log.csv", [samples]{ return QueueLogCsv(*samples); }});
+    }
+    if (opts.linkStep > 0) {
+        // Paths come from the routing tables, so the report is built here.
+        ColumnarTable series = links.Series();
+        std::string report = links.Report(*rows, opts.hotLinks).dump(2);
+        out.files.push_back({"link_util.bin", [series]{ return series.Encode(); }});
+        out.files.push_back({"link_report.json", [report]{ return report; }});
+    }
+
+    json meta;
+    meta["scenario"]=scenario;
+    meta["seed"]=opts.seed;
+    meta["rng_run"]=run;
+    meta["num_cameras"]=numCameras;
+    meta["channel"]={
+        {"mode",opts.channel},
+        {"propagation",opts.staticChannel ? "static" : "live"},
+        {"layout",opts.layout},
+        {"bss",opts.bss},
+        {"media",numMedia},
+        {"plan",opts.channelPlan}
+    };
+    if (!mediumChannel.empty()) meta["channel"]["planned"]=plan.Json();
+    meta["camera_app"]=opts.cameraApp;
+    meta["inference"]={{"mode",opts.inference}};
+    if (opts.inference=="server"){
+        meta["inference"]["slots"]=opts.computeSlots;
+        meta["inference"]["queue_limit"]=opts.queueLimit;
+        meta["inference"]["batch_max"]=opts.batchMax;
+        meta["inference"]["batch_wait_s"]=opts.batchWait;
+        meta["inference"]["servers"]=servers.Json();
+        meta["inference"]["e2e"]=resultSink->Json();
+    }
+    meta["monitor"]=opts.monitor;
+    if (opts.flowSketch)
+        meta["flow_sketch"]={{"alpha",sketches.Alpha()},{"max_buckets",sketches.MaxBuckets()},{"flows",sketches.Flows()}};
+    if (opts.sampleStep > 0)
+        meta["timeseries"]={{"step_s",opts.sampleStep},{"samples",sampler.Samples()},{"rows",sampler.Table().Rows()}};
+    if (opts.queueStep > 0)
+        meta["queue_log"]={{"step_s",opts.queueStep},{"nodes",queues.Nodes()},{"samples",queues.Samples()}};
+    if (opts.linkStep > 0) meta["link_util"]={{"step_s",opts.linkStep},{"hot_links",opts.hotLinks}};
+    meta["populate_arp"]=opts.populateArp;
+    meta["fast_associate"]=opts.fastAssociate;
+    meta["routing"]={{"mode",opts.routing},{"addressing",opts.addressing},{"routes",routes}};
+    meta["perf"]=perf.Json();
+    if (!pruned.empty()) {
+        uint64_t rxEvents = 0, rxPruned = 0;
+        for (auto &ch:pruned){ rxEvents += ch->GetDeliveredCount(); rxPruned += ch->GetPrunedCount(); }
+        meta["channel"]["interference_range"]=opts.interferenceRange;
+        meta["channel"]["rx_events"]=rxEvents;
+        meta["channel"]["rx_pruned"]=rxPruned;
+    }
+    meta["cameras"]=json::array();
+    for (auto &c:configs)
+        meta["cameras"].push_back({
+            {"id",c.id},
+            {"processing",c.processing},
+            {"model",c.model},
+            {"frame_size",c.frameSize},
+            {"frame_interval",c.frameInterval},
+            {"inference_delay",c.inferenceDelay},
+            {"result_size",c.resultSize}
+        });
+    out.files.push_back({"config.json", [meta]{ return meta.dump(4); }});
+
+    // ===== CAMERA ↔ FLOW JOIN =====
+    FlowIndex flowIndex(*rows);
+    Ptr<Node> sink = cloud.Get(0);
+    json joined = json::array();
+    for (auto &c:configs){
+        Ptr<Node> procNode = procNodeOf(c);
+        joined.push_back({
+            {"camera_id",c.id},
+            {"processing",c.processing},
+            {"model",c.model},
+            {"camera_node",cameras.Get(c.id)->GetId()},
+            {"processing_node",procNode->GetId()},
+            {"sink_node",sink->GetId()},
+            {"frame_flow",FlowRecord(flowIndex.Find(PrimaryAddress(procNode),kFramePortBase+c.id))},
+            {"result_flow",FlowRecord(flowIndex.Find(PrimaryAddress(sink),kResultPortBase+c.id))}
+        });
+        if (frameSinks[c.id]) joined.back()["frames"]=frameSinks[c.id]->Json();
+        if (opts.inference=="server"){
+            joined.back()["frames"]=servers.CameraJson(procNode, c.id);
+            joined.back()["e2e"]=resultSink->CameraJson(c.id);
+        }
+    }
+    out.files.push_back({"camera_flows.json", [joined]{ return joined.dump(4); }});
+
+    // Drop leftovers of an earlier run (possibly in another format).
+    if (opts.archive.empty()) std::filesystem::remove_all(dir);
+    writer.Submit(std::move(out));
+
+    Simulator::Destroy();
     return 0;
 }
+
+// ================= MAIN =================
+int main(int argc, char *argv[]) {
+    Time::SetResolution(Time::NS);
+    LogComponentEnable("AirportSimulation", LOG_LEVEL_INFO);
+
+    uint32_t scenarioCount = 100; // default
+    uint32_t firstScenario = 0;
+    uint32_t jobs = 1;
+    uint32_t seed = 1;
+    std::string flowFormat = "xml";
+    bool flowSketch = false;
+    double sketchAlpha = 0.01;
+    double sampleStep = 0;
+    double queueStep = 0;
+    double linkStep = 0;
+    uint32_t hotLinks = 5;
+    uint32_t writerQueue = 2;
+    bool syncOutputs = false;
+    std::string archive;
+    bool staticChannel = false;
+    std::string channel = "yans";
+    double interferenceRange = 250.0;
+    std::string layout = "origin";
+    std::string bss = "shared";
+    std::string channelPlan = "unique";
+    std::string cameraApp = "onoff";
+    std::string inference = "open";
+    uint32_t computeSlots = 1;
+    uint32_t queueLimit = 0;
+    uint32_t batchMax = 1;
+    double batchWaitMs = 0;
+    std::string monitor = "all";
+    std::string routing = "global";
+    uint32_t cameraCount = 0;
+    std::string addressing = "flat";
+    bool populateArp = false;
+    bool fastAssociate = false;
+    CommandLine cmd;
+    cmd.AddValue("scenarios", "Number of scenarios to simulate", scenarioCount);
+    cmd.AddValue("firstScenario", "Index of the first scenario to run", firstScenario);
+    cmd.AddValue("jobs", "Scenarios to run in parallel child processes (0 = one per core)", jobs);
+    cmd.AddValue("seed", "Sweep seed; scenario N uses RngRun = base RngRun + N", seed);
+    cmd.AddValue("flowFormat", "Flow statistics output: xml, columnar (flow.bin) or both", flowFormat);
+    cmd.AddValue("flowSketch", "Per-flow delay/jitter quantile sketches (flow_sketch.bin, flow_tails.bin)", flowSketch);
+    cmd.AddValue("sketchAlpha", "Relative accuracy of the flow sketches", sketchAlpha);
+    cmd.AddValue("sampleStep", "Per-flow time series step in seconds (timeseries.bin); 0 = off", sampleStep);
+    cmd.AddValue("queueStep", "Per-node queue occupancy log step in seconds (network_log.csv); 0 = off", queueStep);
+    cmd.AddValue("linkStep", "Link/BSS utilization step in seconds (link_util.bin, link_report.json); 0 = off", linkStep);
+    cmd.AddValue("hotLinks", "Most utilized links/BSSes whose flows are listed in link_report.json", hotLinks);
+    cmd.AddValue("writerQueue", "Scenarios buffered for the background writer (0 = write inline)", writerQueue);
+    cmd.AddValue("fsync", "fsync every output file before moving on", syncOutputs);
+    cmd.AddValue("archive", "Write all scenarios into this single indexed archive file", archive);
+    cmd.AddValue("staticChannel", "Precompute Wi-Fi propagation loss/delay between static nodes", staticChannel);
+    cmd.AddValue("channel", "Wi-Fi channel: yans, or pruned (spectrum channel delivering only within --interferenceRange)", channel);
+    cmd.AddValue("interferenceRange", "Receiver range of the pruned channel in metres", interferenceRange);
+    cmd.AddValue("bss", "shared (one SSID and channel) or perAp (own SSID and channel per access point)", bss);
+    cmd.AddValue("channelPlan", "With --bss=perAp: unique (own medium per BSS) or plan real channels over 2.4, 5 or dual bands", channelPlan);
+    cmd.AddValue("layout", "Wi-Fi node placement: origin (all co-located) or terminal (AP grid)", layout);
+    cmd.AddValue("cameraApp", "Frame source: onoff (constant-rate packets) or frames (per-frame fragment bursts with latency)", cameraApp);
+    cmd.AddValue("inference", "Results: open (fixed-rate flow per camera) or server (one result per frame processed by an InferenceServer)", inference);
+    cmd.AddValue("computeSlots", "Frames each InferenceServer processes in parallel", computeSlots);
+    cmd.AddValue("queueLimit", "Frames waiting per InferenceServer before drops (0 = unbounded)", queueLimit);
+    cmd.AddValue("batchMax", "Frames of one model an InferenceServer on a shared node runs as one batch", batchMax);
+    cmd.AddValue("batchWaitMs", "Longest a frame waits for its batch to fill (ms)", batchWaitMs);
+    cmd.AddValue("monitor", "FlowMonitor probes on all nodes, or only on endpoints (cameras, processing nodes, sink)", monitor);
+    cmd.AddValue("routing", "global (SPF over all nodes), tree (static routes from the tier structure) or nix (on-demand nix vectors)", routing);
+    cmd.AddValue("addressing", "flat (one 10.0.0.0/16) or hier (per-BSS and per-link-group subnets)", addressing);
+    cmd.AddValue("populateArp", "Pre-populate all neighbour (ARP) caches before the run", populateArp);
+    cmd.AddValue("fastAssociate", "Skip beacons/association: ad hoc Wi-Fi with cameras routed via their accessId AP", fastAssociate);
+    cmd.AddValue("cameras", "Cameras per scenario, overriding 150-200 (0 = default)", cameraCount);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(flowFormat != "xml" && flowFormat != "columnar" && flowFormat != "both",
+                    "Unknown --flowFormat " << flowFormat);
+    NS_ABORT_MSG_IF(sketchAlpha <= 0 || sketchAlpha >= 1, "--sketchAlpha must be in (0, 1)");
+    NS_ABORT_MSG_IF(sampleStep < 0, "--sampleStep must not be negative");
+    NS_ABORT_MSG_IF(queueStep < 0, "--queueStep must not be negative");
+    NS_ABORT_MSG_IF(linkStep < 0, "--linkStep must not be negative");
+    NS_ABORT_MSG_IF(channel != "yans" && channel != "pruned", "Unknown --channel " << channel);
+    NS_ABORT_MSG_IF(interferenceRange < 1.0, "--interferenceRange must be at least 1 m");
+    NS_ABORT_MSG_IF(layout != "origin" && layout != "terminal", "Unknown --layout " << layout);
+    NS_ABORT_MSG_IF(bss != "shared" && bss != "perAp", "Unknown --bss " << bss);
+    NS_ABORT_MSG_IF(channelPlan != "unique" && AvailableChannels(channelPlan).empty(), "Unknown --channelPlan " << channelPlan);
+    NS_ABORT_MSG_IF(channelPlan != "unique" && bss != "perAp", "--channelPlan needs --bss=perAp");
+    NS_ABORT_MSG_IF(cameraApp != "onoff" && cameraApp != "frames", "Unknown --cameraApp " << cameraApp);
+    NS_ABORT_MSG_IF(inference != "open" && inference != "server", "Unknown --inference " << inference);
+    NS_ABORT_MSG_IF(inference == "server" && cameraApp != "frames", "--inference=server needs --cameraApp=frames");
+    NS_ABORT_MSG_IF(computeSlots < 1, "--computeSlots must be at least 1");
+    NS_ABORT_MSG_IF(batchMax < 1 || batchWaitMs < 0, "--batchMax must be at least 1 and --batchWaitMs not negative");
+    NS_ABORT_MSG_IF(monitor != "all" && monitor != "endpoints", "Unknown --monitor " << monitor);
+    NS_ABORT_MSG_IF(routing != "global" && routing != "tree" && routing != "nix", "Unknown --routing " << routing);
+    NS_ABORT_MSG_IF(addressing != "flat" && addressing != "hier", "Unknown --addressing " << addressing);
+    NS_ABORT_MSG_IF(fastAssociate && routing == "nix", "--fastAssociate needs --routing=global or tree");
+
+    // --RngRun (default 1) still selects the base run of the sweep.
+    ScenarioOptions opts{};
+    opts.seed = seed;
+    opts.baseRun = RngSeedManager::GetRun();
+    opts.flowFormat = flowFormat;
+    opts.archive = archive;
+    opts.flowSketch = flowSketch;
+    opts.sketchAlpha = sketchAlpha;
+    opts.sampleStep = sampleStep;
+    opts.queueStep = queueStep;
+    opts.linkStep = linkStep;
+    opts.hotLinks = hotLinks;
+    opts.staticChannel = staticChannel;
+    opts.channel = channel;
+    opts.interferenceRange = interferenceRange;
+    opts.layout = layout;
+    opts.bss = bss;
+    opts.channelPlan = channelPlan;
+    opts.cameraApp = cameraApp;
+    opts.inference = inference;
+    opts.computeSlots = computeSlots;
+    opts.queueLimit = queueLimit;
+    opts.batchMax = batchMax;
+    opts.batchWait = batchWaitMs / 1000.0;
+    opts.monitor = monitor;
+    opts.routing = routing;
+    opts.addressing = addressing;
+    opts.populateArp = populateArp;
+    opts.fastAssociate = fastAssociate;
+    opts.cameras = cameraCount;
+
+    NS_ABORT_MSG_IF(!archive.empty() && !ScenarioArchiveWriter(archive).Create(),
+                    "Cannot create archive " << archive);
+
+    // In-process sweeps share one writer, so output overlaps the next
+    // scenario. Forked sweeps give every scenario its own writer, closed
+    // before returning: the child exits right after, and a scenario run in
+    // the parent (fork failed) must not leave a thread behind for the
+    // children forked later.
+    std::unique_ptr<AsyncOutputWriter> writer;
+    bool forked = ResolveJobs(jobs) > 1;
+
+    auto results = RunScenarioSweep(firstScenario, scenarioCount, jobs,
+        [&](uint32_t scenario) {
+            if (forked) {
+                AsyncOutputWriter own(writerQueue, syncOutputs, archive);
+                int rc = RunScenario(scenario, opts, own);
+                return own.Close() > 0 ? 1 : rc;
+            }
+            if (!writer) writer.reset(new AsyncOutputWriter(writerQueue, syncOutputs, archive));
+            return RunScenario(scenario, opts, *writer);
+        },
+        [&](uint32_t scenario) { return archive.empty() ? ScenarioDir(scenario) : archive; });
+
+    bool writeFailed = writer && writer->Close() > 0;
+    if (!archive.empty() && !ScenarioArchiveWriter(archive).Finalize())
+        writeFailed = true;
+    if (writeFailed)
+        NS_LOG_ERROR("Some scenario outputs could not be written");
+
+    uint32_t failed = 0;
+    for (auto &r : results) {
+        if (r.status != 0) {
+            NS_LOG_ERROR("Scenario " << r.scenario << " failed with status " << r.status
+                         << " (" << r.outputDir << ")");
+            failed++;
+        }
+    }
+
+    NS_LOG_INFO("All scenarios completed (" << results.size() - failed << "/" << results.size() << " ok).");
+    return (failed || writeFailed) ? 1 : 0;
+}
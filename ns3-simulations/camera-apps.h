@@ -0,0 +1,271 @@
+#ifndef CAMERA_APPS_H
+#define CAMERA_APPS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include <algorithm>
+#include <map>
+#include <nlohmann/json.hpp>
+
+namespace ns3 {
+
+/* ================= CAMERA FRAME APPLICATIONS ================= */
+// A camera sends one video frame per interval as a burst of MTU-sized UDP
+// fragments, all from a single event. Each fragment carries a FrameTag
+// (camera, frame number, fragment index and count, capture time), so the
+// receiving side can reassemble frames and measure per-frame latency: the
+// time from capture until the last fragment of a frame has arrived.
+
+class FrameTag : public Tag {
+public:
+    uint32_t cameraId = 0;
+    uint32_t frameId = 0;
+    uint16_t fragment = 0;
+    uint16_t fragments = 0;
+    int64_t capturedNs = 0;
+
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::FrameTag").SetParent<Tag>().AddConstructor<FrameTag>();
+        return tid;
+    }
+    TypeId GetInstanceTypeId() const override { return GetTypeId(); }
+
+    uint32_t GetSerializedSize() const override { return 4 + 4 + 2 + 2 + 8; }
+
+    void Serialize(TagBuffer i) const override {
+        i.WriteU32(cameraId);
+        i.WriteU32(frameId);
+        i.WriteU16(fragment);
+        i.WriteU16(fragments);
+        i.WriteU64((uint64_t)capturedNs);
+    }
+
+    void Deserialize(TagBuffer i) override {
+        cameraId = i.ReadU32();
+        frameId = i.ReadU32();
+        fragment = i.ReadU16();
+        fragments = i.ReadU16();
+        capturedNs = (int64_t)i.ReadU64();
+    }
+
+    void Print(std::ostream& os) const override {
+        os << "camera=" << cameraId << " frame=" << frameId << " fragment=" << fragment << "/" << fragments;
+    }
+
+    Time Captured() const { return NanoSeconds(capturedNs); }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(FrameTag);
+
+class CameraFrameApp : public Application {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::CameraFrameApp")
+            .SetParent<Application>()
+            .AddConstructor<CameraFrameApp>()
+            .AddAttribute("Remote", "Destination of the frames",
+                          AddressValue(),
+                          MakeAddressAccessor(&CameraFrameApp::m_remote),
+                          MakeAddressChecker())
+            .AddAttribute("CameraId", "Camera id written into every FrameTag",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&CameraFrameApp::m_cameraId),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FrameSize", "Bytes per frame",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&CameraFrameApp::m_frameSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("FrameInterval", "Time between frames",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&CameraFrameApp::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("FragmentSize", "Largest UDP payload; 1472 fills a 1500-byte IP MTU",
+                          UintegerValue(1472),
+                          MakeUintegerAccessor(&CameraFrameApp::m_fragmentSize),
+                          MakeUintegerChecker<uint32_t>(1, 65507));
+        return tid;
+    }
+
+    uint32_t GetFramesSent() const { return m_frameId; }
+    uint64_t GetFragmentsSent() const { return m_fragmentsSent; }
+
+private:
+    void StartApplication() override {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind();
+        m_socket->Connect(m_remote);
+        m_next = Simulator::ScheduleNow(&CameraFrameApp::SendFrame, this);
+    }
+
+    void StopApplication() override {
+        m_next.Cancel();
+        if (m_socket) m_socket->Close();
+    }
+
+    // The whole burst goes out in this one event; the socket and the device
+    // queue pace the fragments onto the link.
+    void SendFrame() {
+        FrameTag tag;
+        tag.cameraId = m_cameraId;
+        tag.frameId = m_frameId++;
+        tag.fragments = (uint16_t)((m_frameSize + m_fragmentSize - 1) / m_fragmentSize);
+        tag.capturedNs = Simulator::Now().GetNanoSeconds();
+
+        uint32_t left = m_frameSize;
+        for (uint16_t f = 0; f < tag.fragments; f++) {
+            Ptr<Packet> p = Create<Packet>(std::min(left, m_fragmentSize));
+            left -= p->GetSize();
+            tag.fragment = f;
+            p->AddPacketTag(tag);
+            m_socket->Send(p);
+            m_fragmentsSent++;
+        }
+        m_next = Simulator::Schedule(m_interval, &CameraFrameApp::SendFrame, this);
+    }
+
+    Address m_remote;
+    uint32_t m_cameraId = 0;
+    uint32_t m_frameSize = 1500;
+    Time m_interval;
+    uint32_t m_fragmentSize = 1472;
+
+    Ptr<Socket> m_socket;
+    EventId m_next;
+    uint32_t m_frameId = 0;
+    uint64_t m_fragmentsSent = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CameraFrameApp);
+
+// Counts the fragments of every frame of one camera until it is complete.
+// Frames are numbered in capture order; once a frame completes, older
+// frames still missing fragments are given up as incomplete.
+class FrameReassembler {
+public:
+    // Returns true when this fragment completes its frame.
+    bool Add(const FrameTag& tag) {
+        if (m_completed && tag.frameId <= m_last) return false;
+        uint16_t& have = m_pending[tag.frameId];
+        if (++have < tag.fragments) return false;
+
+        m_pending.erase(tag.frameId);
+        for (auto it = m_pending.begin(); it != m_pending.end() && it->first < tag.frameId;) {
+            it = m_pending.erase(it);
+            m_incomplete++;
+        }
+        m_completed = true;
+        m_last = tag.frameId;
+        return true;
+    }
+
+    // Frames given up so far plus those still waiting for fragments.
+    uint64_t Incomplete() const { return m_incomplete + m_pending.size(); }
+
+private:
+    std::map<uint32_t, uint16_t> m_pending;   // frame id -> fragments seen
+    bool m_completed = false;
+    uint32_t m_last = 0;                      // newest completed frame
+    uint64_t m_incomplete = 0;
+};
+
+// Receives the frames of one camera and records per-frame latency.
+class FrameSinkApp : public Application {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::FrameSinkApp")
+            .SetParent<Application>()
+            .AddConstructor<FrameSinkApp>()
+            .AddAttribute("Local", "Address to listen on",
+                          AddressValue(),
+                          MakeAddressAccessor(&FrameSinkApp::m_local),
+                          MakeAddressChecker())
+            .AddTraceSource("Frame", "A frame has been received completely",
+                            MakeTraceSourceAccessor(&FrameSinkApp::m_frameTrace),
+                            "ns3::FrameSinkApp::FrameCallback");
+        return tid;
+    }
+
+    typedef void (*FrameCallback)(const FrameTag& tag, Time latency);
+
+    uint64_t GetFramesReceived() const { return m_frames; }
+    uint64_t GetFramesIncomplete() const { return m_reassembler.Incomplete(); }
+
+    nlohmann::json Json() const {
+        return {
+            {"frames_received", m_frames},
+            {"frames_incomplete", GetFramesIncomplete()},
+            {"fragments_received", m_fragments},
+            {"latency_mean_s", m_frames ? m_latencySum / m_frames : 0.0},
+            {"latency_max_s", m_latencyMax}
+        };
+    }
+
+private:
+    void StartApplication() override {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind(m_local);
+        m_socket->SetRecvCallback(MakeCallback(&FrameSinkApp::Receive, this));
+    }
+
+    void StopApplication() override {
+        if (m_socket) m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+
+    void Receive(Ptr<Socket> socket) {
+        while (Ptr<Packet> p = socket->Recv()) {
+            FrameTag tag;
+            if (!p->PeekPacketTag(tag)) continue;
+            m_fragments++;
+            if (!m_reassembler.Add(tag)) continue;
+
+            Time latency = Simulator::Now() - tag.Captured();
+            m_frames++;
+            m_latencySum += latency.GetSeconds();
+            m_latencyMax = std::max(m_latencyMax, latency.GetSeconds());
+            m_frameTrace(tag, latency);
+        }
+    }
+
+    Address m_local;
+    Ptr<Socket> m_socket;
+    FrameReassembler m_reassembler;
+    uint64_t m_frames = 0;
+    uint64_t m_fragments = 0;
+    double m_latencySum = 0;
+    double m_latencyMax = 0;
+    TracedCallback<const FrameTag&, Time> m_frameTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(FrameSinkApp);
+
+inline Ptr<CameraFrameApp> InstallCameraFrameApp(Ptr<Node> camera, uint32_t cameraId, const Address& remote,
+                                                 uint32_t frameSize, Time interval, Time start, Time stop) {
+    Ptr<CameraFrameApp> app = CreateObject<CameraFrameApp>();
+    app->SetAttribute("Remote", AddressValue(remote));
+    app->SetAttribute("CameraId", UintegerValue(cameraId));
+    app->SetAttribute("FrameSize", UintegerValue(frameSize));
+    app->SetAttribute("FrameInterval", TimeValue(interval));
+    camera->AddApplication(app);
+    app->SetStartTime(start);
+    app->SetStopTime(stop);
+    return app;
+}
+
+// One camera's frame flow: a CameraFrameApp on the camera sending to port
+// on dst, and the FrameSinkApp listening there, which is returned.
+inline Ptr<FrameSinkApp> InstallFrameFlow(Ptr<Node> camera, uint32_t cameraId, Ptr<Node> dst, Ipv4Address dstAddr,
+                                          uint16_t port, uint32_t frameSize, Time interval, Time start, Time stop) {
+    Ptr<FrameSinkApp> sink = CreateObject<FrameSinkApp>();
+    sink->SetAttribute("Local", AddressValue(InetSocketAddress(Ipv4Address::GetAny(), port)));
+    dst->AddApplication(sink);
+    sink->SetStartTime(Seconds(0));
+
+    InstallCameraFrameApp(camera, cameraId, InetSocketAddress(dstAddr, port), frameSize, interval, start, stop);
+    return sink;
+}
+
+} // namespace ns3
+
+#endif // CAMERA_APPS_H
@@ -0,0 +1,76 @@
+#ifndef CAMERA_FLOW_JOIN_H
+#define CAMERA_FLOW_JOIN_H
+
+#include "ns3/flow-monitor-module.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "flow-stats-writer.h"
+
+namespace ns3 {
+
+/* ================= CAMERA ↔ FLOW JOIN ================= */
+// Frame flows go to port 9000 + camera id and result flows to port
+// 10000 + camera id. The source address is picked by routing, so flows are
+// matched on (destination address, destination port) only.
+
+const uint16_t kFramePortBase  = 9000;
+const uint16_t kResultPortBase = 10000;
+
+class FlowIndex {
+public:
+    explicit FlowIndex(const std::vector<FlowRow>& rows) : m_rows(rows) {
+        for (size_t i = 0; i < rows.size(); i++)
+            m_byDst[{rows[i].tuple.destinationAddress.Get(), rows[i].tuple.destinationPort}] = i;
+    }
+
+    const FlowRow* Find(Ipv4Address dst, uint16_t port) const {
+        auto it = m_byDst.find({dst.Get(), port});
+        return it == m_byDst.end() ? nullptr : &m_rows[it->second];
+    }
+
+private:
+    const std::vector<FlowRow>& m_rows;
+    std::map<std::pair<uint32_t, uint16_t>, size_t> m_byDst;
+};
+
+inline std::string AddressString(Ipv4Address a) {
+    std::ostringstream os;
+    a.Print(os);
+    return os.str();
+}
+
+// Flow stats of one joined flow, or null if FlowMonitor never saw it.
+inline nlohmann::json FlowRecord(const FlowRow* r) {
+    if (!r) return nullptr;
+    const FlowMonitor::FlowStats& s = r->stats;
+    return {
+        {"flow_id", r->flowId},
+        {"src_addr", AddressString(r->tuple.sourceAddress)},
+        {"dst_addr", AddressString(r->tuple.destinationAddress)},
+        {"src_port", r->tuple.sourcePort},
+        {"dst_port", r->tuple.destinationPort},
+        {"tx_packets", s.txPackets},
+        {"rx_packets", s.rxPackets},
+        {"lost_packets", s.lostPackets},
+        {"tx_bytes", s.txBytes},
+        {"rx_bytes", s.rxBytes},
+        {"delay_sum_ns", s.delaySum.GetNanoSeconds()},
+        {"jitter_sum_ns", s.jitterSum.GetNanoSeconds()},
+        {"first_tx_time_ns", s.timeFirstTxPacket.GetNanoSeconds()},
+        {"last_rx_time_ns", s.timeLastRxPacket.GetNanoSeconds()}
+    };
+}
+
+inline Ipv4Address PrimaryAddress(Ptr<Node> node) {
+    return node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+}
+
+} // namespace ns3
+
+#endif // CAMERA_FLOW_JOIN_H
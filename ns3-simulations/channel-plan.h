@@ -0,0 +1,164 @@
+#ifndef CHANNEL_PLAN_H
+#define CHANNEL_PLAN_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace ns3 {
+
+/* ================= AP CHANNEL PLAN ================= */
+// Assigns one Wi-Fi channel to every BSS so that BSSes which can hear each
+// other end up on different channels where possible:
+//
+//   1. Interference range: the distance at which the propagation loss model
+//      brings the default transmit power down to the CCA threshold.
+//   2. Interference graph: two BSSes conflict if any member (AP or station)
+//      of one lies within that range of any member of the other.
+//   3. DSatur colouring with the available channels. When a BSS has no
+//      conflict-free channel left, it takes the one shared with the fewest
+//      conflicting neighbours; such pairs are reported as conflicts.
+//
+// Ties are broken by index, so the plan depends only on the positions.
+
+struct PlannedChannel {
+    uint16_t number;
+    bool band5GHz;
+
+    // Value for the WifiPhy "ChannelSettings" attribute (20 MHz, primary 0).
+    std::string Settings() const {
+        return "{" + std::to_string(number) + ", 20, " + (band5GHz ? "BAND_5GHZ" : "BAND_2_4GHZ") + ", 0}";
+    }
+};
+
+// Non-overlapping 20 MHz channels: 1/6/11 at 2.4 GHz, UNII-1 and UNII-3
+// (no DFS) at 5 GHz. bands: "2.4", "5" or "dual" (5 GHz channels first).
+inline std::vector<PlannedChannel> AvailableChannels(const std::string& bands) {
+    std::vector<PlannedChannel> out;
+    if (bands == "5" || bands == "dual")
+        for (uint16_t n : {36, 40, 44, 48, 149, 153, 157, 161, 165}) out.push_back({n, true});
+    if (bands == "2.4" || bands == "dual")
+        for (uint16_t n : {1, 6, 11}) out.push_back({n, false});
+    return out;
+}
+
+// WifiPhy defaults (TxPowerStart, CcaSensitivity).
+const double kWifiTxPowerDbm = 16.0206;
+const double kWifiCcaDbm = -82.0;
+
+// Distance (m) at which loss brings txPowerDbm down to thresholdDbm. The
+// model must be deterministic and its loss must grow with distance.
+inline double InterferenceRange(Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm) {
+    Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    auto heard = [&](double d) {
+        b->SetPosition(Vector(d, 0.0, 0.0));
+        return loss->CalcRxPower(txPowerDbm, a, b) >= thresholdDbm;
+    };
+    double lo = 0.1, hi = 100000.0;
+    if (!heard(lo)) return 0.0;
+    if (heard(hi)) return hi;
+    for (int i = 0; i < 60; i++) {
+        double mid = 0.5 * (lo + hi);
+        (heard(mid) ? lo : hi) = mid;
+    }
+    return lo;
+}
+
+struct ChannelPlan {
+    std::vector<PlannedChannel> channels;   // available, in preference order
+    std::vector<uint32_t> channelOf;        // per BSS, index into channels
+    double range = 0;                       // interference range used (m)
+    uint32_t edges = 0;                     // interfering BSS pairs
+    uint32_t conflicts = 0;                 // interfering pairs on one channel
+
+    // Channels actually used, in first-use order; mediumOf[b] indexes it.
+    std::vector<uint32_t> Used(std::vector<uint32_t>& mediumOf) const {
+        std::vector<uint32_t> used;
+        std::vector<int64_t> slot(channels.size(), -1);
+        mediumOf.assign(channelOf.size(), 0);
+        for (uint32_t b = 0; b < channelOf.size(); b++) {
+            uint32_t c = channelOf[b];
+            if (slot[c] < 0) { slot[c] = used.size(); used.push_back(c); }
+            mediumOf[b] = slot[c];
+        }
+        return used;
+    }
+
+    nlohmann::json Json() const {
+        nlohmann::json j = {
+            {"interference_range", range},
+            {"interfering_pairs", edges},
+            {"co_channel_pairs", conflicts},
+            {"bss", nlohmann::json::array()}
+        };
+        for (uint32_t b = 0; b < channelOf.size(); b++) {
+            const PlannedChannel& c = channels[channelOf[b]];
+            j["bss"].push_back({{"bss", b}, {"channel", c.number}, {"band", c.band5GHz ? "5GHz" : "2.4GHz"}});
+        }
+        return j;
+    }
+};
+
+// members[b]: positions of the AP and stations of BSS b.
+inline ChannelPlan PlanChannels(const std::vector<std::vector<Vector>>& members, double range,
+                                const std::vector<PlannedChannel>& channels) {
+    NS_ABORT_MSG_IF(channels.empty(), "No channels to plan with");
+    uint32_t n = members.size();
+    ChannelPlan plan;
+    plan.channels = channels;
+    plan.range = range;
+
+    std::vector<std::vector<uint32_t>> adj(n);
+    for (uint32_t a = 0; a < n; a++)
+        for (uint32_t b = a + 1; b < n; b++) {
+            bool hit = false;
+            for (const Vector& p : members[a]) {
+                for (const Vector& q : members[b])
+                    if (CalculateDistance(p, q) <= range) { hit = true; break; }
+                if (hit) break;
+            }
+            if (!hit) continue;
+            adj[a].push_back(b);
+            adj[b].push_back(a);
+            plan.edges++;
+        }
+
+    const uint32_t none = UINT32_MAX;
+    plan.channelOf.assign(n, none);
+    for (uint32_t step = 0; step < n; step++) {
+        // Most distinct neighbour channels first, then most neighbours.
+        uint32_t v = none;
+        size_t bestSat = 0, bestDeg = 0;
+        for (uint32_t u = 0; u < n; u++) {
+            if (plan.channelOf[u] != none) continue;
+            std::vector<bool> seen(channels.size(), false);
+            size_t sat = 0;
+            for (uint32_t w : adj[u])
+                if (plan.channelOf[w] != none && !seen[plan.channelOf[w]]) { seen[plan.channelOf[w]] = true; sat++; }
+            if (v == none || sat > bestSat || (sat == bestSat && adj[u].size() > bestDeg)) {
+                v = u;
+                bestSat = sat;
+                bestDeg = adj[u].size();
+            }
+        }
+
+        std::vector<uint32_t> sharing(channels.size(), 0);
+        for (uint32_t w : adj[v])
+            if (plan.channelOf[w] != none) sharing[plan.channelOf[w]]++;
+        uint32_t c = 0;
+        for (uint32_t k = 1; k < channels.size(); k++)
+            if (sharing[k] < sharing[c]) c = k;
+        plan.channelOf[v] = c;
+        plan.conflicts += sharing[c];
+    }
+    return plan;
+}
+
+} // namespace ns3
+
+#endif // CHANNEL_PLAN_H
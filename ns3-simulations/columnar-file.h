@@ -0,0 +1,112 @@
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* ================= COLUMNAR FILE ================= */
+// Fixed-width, column-major binary table. Layout (all little-endian):
+//
+//   "COLSTAT1" | u32 version | u32 nColumns | u64 nRows
+//   nColumns x { char name[32]; u8 type; u8 width; u8 pad[6]; u64 offset }
+//   column data, each column starting 8-byte aligned at its `offset`
+//
+// The header is self-describing, so a reader can mmap the file and view
+// every column as a plain array without parsing anything per row.
+
+enum ColumnType : uint8_t {
+    COL_U8  = 1,
+    COL_U16 = 2,
+    COL_U32 = 3,
+    COL_U64 = 4,
+    COL_I64 = 5,
+    COL_F64 = 6
+};
+
+class ColumnarTable {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kNameSize = 32;
+
+    size_t AddColumn(const std::string& name, ColumnType type) {
+        m_columns.push_back({name.substr(0, kNameSize - 1), type, WidthOf(type), {}});
+        return m_columns.size() - 1;
+    }
+
+    // Appends the low `width` bytes of value to the column.
+    void Append(size_t col, uint64_t value) {
+        Column& c = m_columns[col];
+        for (uint8_t b = 0; b < c.width; b++)
+            c.data.push_back((uint8_t)(value >> (8 * b)));
+    }
+
+    void AppendSigned(size_t col, int64_t value) { Append(col, (uint64_t)value); }
+
+    void AppendDouble(size_t col, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Append(col, bits);
+    }
+
+    uint64_t Rows() const {
+        return m_columns.empty() ? 0 : m_columns[0].data.size() / m_columns[0].width;
+    }
+
+    std::string Encode() const {
+        uint64_t rows = Rows();
+        uint64_t offset = Align(8 + 4 + 4 + 8 + m_columns.size() * (kNameSize + 16));
+
+        std::string out;
+        out.append("COLSTAT1", 8);
+        Put(out, kVersion, 4);
+        Put(out, m_columns.size(), 4);
+        Put(out, rows, 8);
+
+        for (auto& c : m_columns) {
+            char name[kNameSize] = {};
+            std::memcpy(name, c.name.data(), c.name.size());
+            out.append(name, kNameSize);
+            Put(out, c.type, 1);
+            Put(out, c.width, 1);
+            Put(out, 0, 6);
+            Put(out, offset, 8);
+            offset = Align(offset + rows * c.width);
+        }
+
+        for (auto& c : m_columns) {
+            out.resize(Align(out.size()), '\0');
+            out.append((const char*)c.data.data(), c.data.size());
+        }
+        return out;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        uint8_t width;
+        std::vector<uint8_t> data;
+    };
+
+    static uint8_t WidthOf(ColumnType type) {
+        switch (type) {
+            case COL_U8:  return 1;
+            case COL_U16: return 2;
+            case COL_U32: return 4;
+            default:      return 8;
+        }
+    }
+
+    static uint64_t Align(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+    static void Put(std::string& out, uint64_t value, size_t bytes) {
+        for (size_t b = 0; b < bytes; b++)
+            out.push_back((char)(b < 8 ? (value >> (8 * b)) & 0xff : 0));
+    }
+
+    std::vector<Column> m_columns;
+};
+
+#endif // COLUMNAR_FILE_H
@@ -0,0 +1,285 @@
+#ifndef FLOW_SKETCH_H
+#define FLOW_SKETCH_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include "columnar-file.h"
+#include "flow-stats-writer.h"
+
+namespace ns3 {
+
+/* ================= FLOW DELAY SKETCHES ================= */
+// Per-flow one-way delay and jitter (|delay - previous delay|, as FlowMonitor
+// defines it) kept in log-bucket sketches (DDSketch): bucket k counts the
+// values in (gamma^(k-1), gamma^k] ns with gamma = (1 + alpha) / (1 - alpha),
+// so every quantile is within a relative error alpha of the true value.
+// Values below 1 ns share a zero bucket (index -1). Sketches with the same
+// alpha merge by adding counts, so replicated scenarios can be combined from
+// the written buckets alone.
+//
+// Memory is bounded per sketch: past maxBuckets the lowest buckets are folded
+// together, which only coarsens the low quantiles.
+//
+// Packets are stamped at SendOutgoing on their source node and measured at
+// LocalDeliver on their destination, keyed by five-tuple; the FlowMonitor flow
+// id is joined in on output.
+
+class LogBucketSketch {
+public:
+    explicit LogBucketSketch(double alpha = 0.01, uint32_t maxBuckets = 1024)
+        : m_gamma((1 + alpha) / (1 - alpha)), m_logGamma(std::log(m_gamma)), m_maxBuckets(maxBuckets) {}
+
+    void Add(double ns) {
+        m_count++;
+        if (ns < 1.0) {
+            m_zero++;
+            return;
+        }
+        Bucket((int32_t)std::ceil(std::log(ns) / m_logGamma))++;
+        Collapse();
+    }
+
+    void Merge(const LogBucketSketch& other) {
+        m_count += other.m_count;
+        m_zero += other.m_zero;
+        other.ForEachBucket([&](int32_t k, uint64_t n) {
+            if (k >= 0) Bucket(k) += n;
+        });
+        Collapse();
+    }
+
+    // Value (ns) at quantile q in [0, 1]; 0 for an empty sketch.
+    double Quantile(double q) const {
+        if (!m_count) return 0.0;
+        uint64_t rank = (uint64_t)(q * (m_count - 1));
+        if (rank < m_zero) return 0.0;
+        uint64_t seen = m_zero;
+        for (size_t i = 0; i < m_counts.size(); i++) {
+            seen += m_counts[i];
+            if (seen > rank) return 2.0 * std::pow(m_gamma, m_offset + (int32_t)i) / (m_gamma + 1);
+        }
+        return 2.0 * std::pow(m_gamma, m_offset + (int32_t)m_counts.size() - 1) / (m_gamma + 1);
+    }
+
+    uint64_t Count() const { return m_count; }
+
+    // f(bucket index, count) for every non-empty bucket, zero bucket first.
+    template <typename F>
+    void ForEachBucket(F&& f) const {
+        if (m_zero) f(-1, m_zero);
+        for (size_t i = 0; i < m_counts.size(); i++)
+            if (m_counts[i]) f(m_offset + (int32_t)i, m_counts[i]);
+    }
+
+private:
+    uint64_t& Bucket(int32_t k) {
+        if (m_counts.empty()) {
+            m_offset = k;
+            m_counts.push_back(0);
+        } else if (k < m_offset) {
+            m_counts.insert(m_counts.begin(), m_offset - k, 0);
+            m_offset = k;
+        } else if (k >= m_offset + (int32_t)m_counts.size()) {
+            m_counts.resize(k - m_offset + 1, 0);
+        }
+        return m_counts[k - m_offset];
+    }
+
+    void Collapse() {
+        if (m_counts.size() <= m_maxBuckets) return;
+        size_t fold = m_counts.size() - m_maxBuckets;
+        for (size_t i = 0; i < fold; i++) m_counts[fold] += m_counts[i];
+        m_counts.erase(m_counts.begin(), m_counts.begin() + fold);
+        m_offset += fold;
+    }
+
+    double m_gamma, m_logGamma;
+    uint32_t m_maxBuckets;
+    uint64_t m_count = 0;
+    uint64_t m_zero = 0;
+    int32_t m_offset = 0;
+    std::vector<uint64_t> m_counts;    // bucket m_offset + i
+};
+
+// Send time of a packet, set where it enters the network.
+class SketchTxTag : public Tag {
+public:
+    int64_t txNs = 0;
+
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::SketchTxTag").SetParent<Tag>().AddConstructor<SketchTxTag>();
+        return tid;
+    }
+    TypeId GetInstanceTypeId() const override { return GetTypeId(); }
+    uint32_t GetSerializedSize() const override { return 8; }
+    void Serialize(TagBuffer i) const override { i.WriteU64((uint64_t)txNs); }
+    void Deserialize(TagBuffer i) override { txNs = (int64_t)i.ReadU64(); }
+    void Print(std::ostream& os) const override { os << "tx=" << txNs; }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(SketchTxTag);
+
+class FlowSketchMonitor {
+public:
+    static constexpr uint8_t kDelay = 0;
+    static constexpr uint8_t kJitter = 1;
+
+    explicit FlowSketchMonitor(double alpha = 0.01, uint32_t maxBuckets = 1024)
+        : m_alpha(alpha), m_maxBuckets(maxBuckets) {}
+
+    void Install(const NodeContainer& nodes) {
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<Ipv4L3Protocol> ip = (*it)->GetObject<Ipv4L3Protocol>();
+            if (!ip) continue;
+            ip->TraceConnectWithoutContext("SendOutgoing", MakeCallback(&FlowSketchMonitor::Sent, this));
+            ip->TraceConnectWithoutContext("LocalDeliver", MakeCallback(&FlowSketchMonitor::Delivered, this));
+        }
+    }
+
+    double Alpha() const { return m_alpha; }
+    uint32_t MaxBuckets() const { return m_maxBuckets; }
+    size_t Flows() const { return m_flows.size(); }
+
+    // Long format, one row per non-empty bucket: flow_id, dst_port, metric
+    // (0 delay, 1 jitter), bucket, count.
+    ColumnarTable EncodeBuckets(const std::vector<FlowRow>& rows) const {
+        ColumnarTable t;
+        size_t flowId = t.AddColumn("flow_id", COL_U32);
+        size_t port   = t.AddColumn("dst_port", COL_U16);
+        size_t metric = t.AddColumn("metric", COL_U8);
+        size_t bucket = t.AddColumn("bucket", COL_I64);
+        size_t count  = t.AddColumn("count", COL_U64);
+        for (auto& r : rows) {
+            const Flow* f = Find(r.tuple);
+            if (!f) continue;
+            for (uint8_t m : {kDelay, kJitter}) {
+                (m == kDelay ? f->delay : f->jitter).ForEachBucket([&](int32_t k, uint64_t n) {
+                    t.Append(flowId, r.flowId);
+                    t.Append(port, r.tuple.destinationPort);
+                    t.Append(metric, m);
+                    t.AppendSigned(bucket, k);
+                    t.Append(count, n);
+                });
+            }
+        }
+        return t;
+    }
+
+    // One row per flow with its delay and jitter tail quantiles (ns).
+    ColumnarTable EncodeTails(const std::vector<FlowRow>& rows) const {
+        static const std::vector<std::pair<const char*, double>> kQuantiles = {
+            {"p50", 0.50}, {"p90", 0.90}, {"p99", 0.99}, {"p999", 0.999}};
+        ColumnarTable t;
+        size_t flowId = t.AddColumn("flow_id", COL_U32);
+        size_t port   = t.AddColumn("dst_port", COL_U16);
+        size_t count  = t.AddColumn("packets", COL_U64);
+        std::vector<size_t> delay, jitter;
+        for (auto& q : kQuantiles) {
+            delay.push_back(t.AddColumn(std::string("delay_") + q.first + "_ns", COL_F64));
+            jitter.push_back(t.AddColumn(std::string("jitter_") + q.first + "_ns", COL_F64));
+        }
+        for (auto& r : rows) {
+            const Flow* f = Find(r.tuple);
+            if (!f) continue;
+            t.Append(flowId, r.flowId);
+            t.Append(port, r.tuple.destinationPort);
+            t.Append(count, f->delay.Count());
+            for (size_t i = 0; i < kQuantiles.size(); i++) {
+                t.AppendDouble(delay[i], f->delay.Quantile(kQuantiles[i].second));
+                t.AppendDouble(jitter[i], f->jitter.Quantile(kQuantiles[i].second));
+            }
+        }
+        return t;
+    }
+
+private:
+    struct Key {
+        uint32_t src, dst;
+        uint16_t srcPort, dstPort;
+        uint8_t protocol;
+
+        bool operator==(const Key& o) const {
+            return src == o.src && dst == o.dst && srcPort == o.srcPort && dstPort == o.dstPort &&
+                   protocol == o.protocol;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t a = ((uint64_t)k.src << 32) | k.dst;
+            uint64_t b = ((uint64_t)k.srcPort << 24) | ((uint64_t)k.dstPort << 8) | k.protocol;
+            return std::hash<uint64_t>()(a * 0x9e3779b97f4a7c15ull ^ b);
+        }
+    };
+
+    struct Flow {
+        LogBucketSketch delay, jitter;
+        bool any = false;
+        double lastDelay = 0;
+    };
+
+    static bool MakeKey(const Ipv4Header& ip, Ptr<const Packet> payload, Key& key) {
+        key = {ip.GetSource().Get(), ip.GetDestination().Get(), 0, 0, ip.GetProtocol()};
+        if (ip.GetFragmentOffset() != 0) return false;
+        if (key.protocol == UdpL4Protocol::PROT_NUMBER) {
+            UdpHeader h;
+            if (payload->PeekHeader(h) < 8) return false;
+            key.srcPort = h.GetSourcePort();
+            key.dstPort = h.GetDestinationPort();
+            return true;
+        }
+        if (key.protocol == TcpL4Protocol::PROT_NUMBER) {
+            TcpHeader h;
+            if (payload->PeekHeader(h) < 20) return false;
+            key.srcPort = h.GetSourcePort();
+            key.dstPort = h.GetDestinationPort();
+            return true;
+        }
+        return false;
+    }
+
+    void Sent(const Ipv4Header&, Ptr<const Packet> payload, uint32_t) {
+        SketchTxTag tag;
+        if (payload->PeekPacketTag(tag)) return;
+        tag.txNs = Simulator::Now().GetNanoSeconds();
+        ConstCast<Packet>(payload)->AddPacketTag(tag);
+    }
+
+    void Delivered(const Ipv4Header& ip, Ptr<const Packet> payload, uint32_t) {
+        SketchTxTag tag;
+        Key key;
+        if (!payload->PeekPacketTag(tag) || !MakeKey(ip, payload, key)) return;
+
+        auto it = m_flows.find(key);
+        if (it == m_flows.end())
+            it = m_flows.emplace(key, Flow{LogBucketSketch(m_alpha, m_maxBuckets),
+                                           LogBucketSketch(m_alpha, m_maxBuckets)}).first;
+        Flow& f = it->second;
+        double delay = (double)(Simulator::Now().GetNanoSeconds() - tag.txNs);
+        f.delay.Add(delay);
+        if (f.any) f.jitter.Add(std::abs(delay - f.lastDelay));
+        f.any = true;
+        f.lastDelay = delay;
+    }
+
+    const Flow* Find(const Ipv4FlowClassifier::FiveTuple& t) const {
+        auto it = m_flows.find({t.sourceAddress.Get(), t.destinationAddress.Get(), t.sourcePort,
+                                t.destinationPort, t.protocol});
+        return it == m_flows.end() ? nullptr : &it->second;
+    }
+
+    double m_alpha;
+    uint32_t m_maxBuckets;
+    std::unordered_map<Key, Flow, KeyHash> m_flows;
+};
+
+} // namespace ns3
+
+#endif // FLOW_SKETCH_H
@@ -0,0 +1,99 @@
+#ifndef FLOW_TIMESERIES_H
+#define FLOW_TIMESERIES_H
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+
+#include <unordered_map>
+
+#include "columnar-file.h"
+
+namespace ns3 {
+
+/* ================= FLOW TIME SERIES ================= */
+// Samples the FlowMonitor every `step` and appends, per flow that changed
+// during the window, the deltas since the previous sample. Windows can be
+// recombined offline into any multiple of the step (sliding or not), so one
+// run gives time-resolved data without re-simulating per window.
+//
+// The sample at stop itself would be scheduled after Simulator::Stop for the
+// same time and so never run; Finish() takes it once Simulator::Run returns.
+//
+// Losses come from CheckForLostPackets, so a packet is counted as lost in
+// the window in which it exceeded the monitor's MaxPerHopDelay, not the one
+// it was sent in.
+
+class FlowTimeSampler {
+public:
+    explicit FlowTimeSampler(Time step) : m_step(step) {
+        m_time    = m_table.AddColumn("time_ns", COL_I64);   // window end
+        m_flowId  = m_table.AddColumn("flow_id", COL_U32);
+        m_txPkts  = m_table.AddColumn("tx_packets", COL_U32);
+        m_rxPkts  = m_table.AddColumn("rx_packets", COL_U32);
+        m_txBytes = m_table.AddColumn("tx_bytes", COL_U64);
+        m_rxBytes = m_table.AddColumn("rx_bytes", COL_U64);
+        m_lost    = m_table.AddColumn("lost_packets", COL_U32);
+        m_delay   = m_table.AddColumn("delay_sum_ns", COL_I64);
+    }
+
+    // Samples at step, 2 step, ... up to and including stop.
+    void Start(Ptr<FlowMonitor> monitor, Time stop) {
+        m_monitor = monitor;
+        m_stop = stop;
+        if (m_step <= stop) m_next = Simulator::Schedule(m_step, &FlowTimeSampler::Sample, this);
+    }
+
+    // Call after Simulator::Run(): takes the sample due at stop.
+    void Finish() {
+        if (m_next.IsExpired() || m_next.GetTs() != (uint64_t)Simulator::Now().GetTimeStep()) return;
+        m_next.Cancel();
+        Sample();
+    }
+
+    Time Step() const { return m_step; }
+    uint32_t Samples() const { return m_samples; }
+    const ColumnarTable& Table() const { return m_table; }
+
+private:
+    struct Totals {
+        uint32_t txPackets = 0, rxPackets = 0, lostPackets = 0;
+        uint64_t txBytes = 0, rxBytes = 0;
+        int64_t delayNs = 0;
+    };
+
+    void Sample() {
+        m_monitor->CheckForLostPackets();
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        for (auto& [id, st] : m_monitor->GetFlowStats()) {
+            Totals& last = m_last[id];
+            int64_t delayNs = st.delaySum.GetNanoSeconds();
+            if (st.txPackets == last.txPackets && st.rxPackets == last.rxPackets &&
+                st.lostPackets == last.lostPackets)
+                continue;
+            m_table.AppendSigned(m_time, now);
+            m_table.Append(m_flowId, id);
+            m_table.Append(m_txPkts, st.txPackets - last.txPackets);
+            m_table.Append(m_rxPkts, st.rxPackets - last.rxPackets);
+            m_table.Append(m_txBytes, st.txBytes - last.txBytes);
+            m_table.Append(m_rxBytes, st.rxBytes - last.rxBytes);
+            m_table.Append(m_lost, st.lostPackets - last.lostPackets);
+            m_table.AppendSigned(m_delay, delayNs - last.delayNs);
+            last = {st.txPackets, st.rxPackets, st.lostPackets, st.txBytes, st.rxBytes, delayNs};
+        }
+        m_samples++;
+        if (Simulator::Now() + m_step <= m_stop)
+            m_next = Simulator::Schedule(m_step, &FlowTimeSampler::Sample, this);
+    }
+
+    Time m_step, m_stop;
+    EventId m_next;
+    Ptr<FlowMonitor> m_monitor;
+    uint32_t m_samples = 0;
+    std::unordered_map<FlowId, Totals> m_last;
+    ColumnarTable m_table;
+    size_t m_time, m_flowId, m_txPkts, m_rxPkts, m_txBytes, m_rxBytes, m_lost, m_delay;
+};
+
+} // namespace ns3
+
+#endif // FLOW_TIMESERIES_H
@@ -0,0 +1,461 @@
+#ifndef INFERENCE_SERVER_H
+#define INFERENCE_SERVER_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "camera-apps.h"
+
+namespace ns3 {
+
+/* ================= INFERENCE SERVER ================= */
+// Closed-loop processing node: frames from CameraFrameApps are reassembled,
+// queued FIFO and run on a fixed number of compute slots. Every completed
+// frame sends one result of the camera's result size to the result sink, so
+// results follow frames and congestion or compute saturation delays them.
+//
+// One server serves all cameras processed on its node. Each camera keeps its
+// own frame port and result destination, so flows still join per camera.
+//
+// Batching: frames of the same model share a queue, and a free slot takes up
+// to MaxBatch of them at once. A partial batch only starts once its oldest
+// frame has waited MaxBatchWait. A batch of b frames runs for
+//
+//   max(inference delay of its frames) * (1 + scaling * (b - 1))
+//
+// where scaling is the model's marginal cost of one more frame. MaxBatch = 1
+// runs every frame alone, as soon as a slot is free.
+//
+// Results carry a ResultTag naming the frame they answer; a ResultSinkApp at
+// the sink turns it into per-camera end-to-end latency percentiles.
+//
+// Throughput and utilization cover the measurement window (the camera apps'
+// start to stop): only results sent inside it count, and a batch running
+// across either edge is credited with the part inside.
+
+// Carried by every result packet: the frame it answers, so the sink can
+// measure frame capture to result arrival across the processing node.
+class ResultTag : public Tag {
+public:
+    uint32_t cameraId = 0;
+    uint32_t frameId = 0;
+    int64_t capturedNs = 0;
+
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::ResultTag").SetParent<Tag>().AddConstructor<ResultTag>();
+        return tid;
+    }
+    TypeId GetInstanceTypeId() const override { return GetTypeId(); }
+
+    uint32_t GetSerializedSize() const override { return 4 + 4 + 8; }
+
+    void Serialize(TagBuffer i) const override {
+        i.WriteU32(cameraId);
+        i.WriteU32(frameId);
+        i.WriteU64((uint64_t)capturedNs);
+    }
+
+    void Deserialize(TagBuffer i) override {
+        cameraId = i.ReadU32();
+        frameId = i.ReadU32();
+        capturedNs = (int64_t)i.ReadU64();
+    }
+
+    void Print(std::ostream& os) const override { os << "camera=" << cameraId << " frame=" << frameId; }
+
+    Time Captured() const { return NanoSeconds(capturedNs); }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ResultTag);
+
+class InferenceServer : public Application {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::InferenceServer")
+            .SetParent<Application>()
+            .AddConstructor<InferenceServer>()
+            .AddAttribute("Slots", "Batches processed in parallel",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&InferenceServer::m_slots),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("QueueLimit", "Frames waiting for a slot before new ones are dropped (0 = no limit)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&InferenceServer::m_queueLimit),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxBatch", "Frames of one model run together at most",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&InferenceServer::m_maxBatch),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxBatchWait", "Longest a frame waits for its batch to fill",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&InferenceServer::m_maxWait),
+                          MakeTimeChecker());
+        return tid;
+    }
+
+    // Call before the application starts. batchScaling: cost of each extra
+    // frame in a batch, relative to running one frame of this model.
+    void AddCamera(uint32_t cameraId, uint16_t port, const std::string& model, Time inferenceDelay,
+                   double batchScaling, uint32_t resultSize, const Address& resultRemote) {
+        auto m = m_modelIndex.find(model);
+        if (m == m_modelIndex.end()) {
+            m = m_modelIndex.emplace(model, m_models.size()).first;
+            m_models.push_back({model, batchScaling});
+        }
+        m_index[cameraId] = m_cameras.size();
+        m_cameras.push_back({cameraId, port, m->second, inferenceDelay, resultSize, resultRemote});
+    }
+
+    uint32_t GetNCameras() const { return m_cameras.size(); }
+
+    // Window throughput_fps and utilization are measured over.
+    void SetWindow(Time start, Time stop) {
+        m_windowStart = start;
+        m_windowStop = stop;
+    }
+
+    nlohmann::json Json() const {
+        double active = (m_windowStop - m_windowStart).GetSeconds();
+        nlohmann::json fill = nlohmann::json::object();
+        for (auto& [size, n] : m_batchSizes) fill[std::to_string(size)] = n;
+        return {
+            {"cameras", m_cameras.size()},
+            {"slots", m_slots},
+            {"max_batch", m_maxBatch},
+            {"max_batch_wait_s", m_maxWait.GetSeconds()},
+            {"frames_received", m_received},
+            {"frames_dropped", m_dropped},
+            {"results_sent", m_completed},
+            {"throughput_fps", active > 0 ? m_windowCompleted / active : 0.0},
+            {"queue_wait_mean_s", m_dispatched ? m_waitSum / m_dispatched : 0.0},
+            {"queue_wait_max_s", m_waitMax},
+            {"queue_max", m_queueMax},
+            {"batches", m_batches},
+            {"batch_fill_mean", m_batches ? (double)m_dispatched / (m_batches * m_maxBatch) : 0.0},
+            {"batch_sizes", fill},
+            {"utilization", active > 0 ? m_busySeconds / (active * m_slots) : 0.0}
+        };
+    }
+
+    // Frames of one camera as seen by this server.
+    nlohmann::json CameraJson(uint32_t cameraId) const {
+        auto it = m_index.find(cameraId);
+        if (it == m_index.end()) return nullptr;
+        const Camera& c = m_cameras[it->second];
+        return {
+            {"frames_received", c.frames},
+            {"frames_incomplete", c.reassembler.Incomplete()},
+            {"frames_dropped", c.dropped},
+            {"results_sent", c.results},
+            {"latency_mean_s", c.frames ? c.latencySum / c.frames : 0.0},
+            {"latency_max_s", c.latencyMax}
+        };
+    }
+
+private:
+    struct Job {
+        uint32_t camera;    // index into m_cameras
+        FrameTag frame;
+        Time queued;
+    };
+
+    struct Model {
+        std::string name;
+        double batchScaling;
+        std::deque<Job> queue;
+    };
+
+    struct Camera {
+        uint32_t id;
+        uint16_t port;
+        uint32_t model;     // index into m_models
+        Time delay;
+        uint32_t resultSize;
+        Address remote;
+
+        Ptr<Socket> rx, tx;
+        FrameReassembler reassembler;
+        uint64_t frames = 0, dropped = 0, results = 0;
+        double latencySum = 0, latencyMax = 0;    // capture -> frame complete
+    };
+
+    void StartApplication() override {
+        for (Camera& c : m_cameras) {
+            c.rx = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+            c.rx->Bind(InetSocketAddress(Ipv4Address::GetAny(), c.port));
+            c.rx->SetRecvCallback(MakeCallback(&InferenceServer::Receive, this));
+            c.tx = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+            c.tx->Bind();
+            c.tx->Connect(c.remote);
+        }
+    }
+
+    void StopApplication() override {
+        for (Camera& c : m_cameras)
+            if (c.rx) c.rx->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        m_wakeup.Cancel();
+    }
+
+    void Receive(Ptr<Socket> socket) {
+        while (Ptr<Packet> p = socket->Recv()) {
+            FrameTag tag;
+            if (!p->PeekPacketTag(tag)) continue;
+            auto it = m_index.find(tag.cameraId);
+            if (it == m_index.end()) continue;
+            Camera& c = m_cameras[it->second];
+            if (!c.reassembler.Add(tag)) continue;
+
+            double latency = (Simulator::Now() - tag.Captured()).GetSeconds();
+            c.frames++;
+            c.latencySum += latency;
+            c.latencyMax = std::max(c.latencyMax, latency);
+            m_received++;
+
+            if (m_queueLimit && m_queued >= m_queueLimit) {
+                c.dropped++;
+                m_dropped++;
+                continue;
+            }
+            m_models[c.model].queue.push_back({it->second, tag, Simulator::Now()});
+            m_queued++;
+            m_queueMax = std::max(m_queueMax, m_queued);
+            Dispatch();
+        }
+    }
+
+    // Starts batches while slots are free: full batches first, otherwise the
+    // model whose oldest frame has waited longest, once it waited MaxBatchWait.
+    void Dispatch() {
+        while (m_busy < m_slots) {
+            Model* pick = nullptr;
+            for (Model& m : m_models) {
+                if (m.queue.empty()) continue;
+                bool full = m.queue.size() >= m_maxBatch;
+                bool pickFull = pick && pick->queue.size() >= m_maxBatch;
+                if (!pick || (full && !pickFull) ||
+                    (full == pickFull && m.queue.front().queued < pick->queue.front().queued))
+                    pick = &m;
+            }
+            if (!pick) return;
+
+            Time due = pick->queue.front().queued + m_maxWait;
+            if (pick->queue.size() < m_maxBatch && due > Simulator::Now()) {
+                m_wakeup.Cancel();
+                m_wakeup = Simulator::Schedule(due - Simulator::Now(), &InferenceServer::Dispatch, this);
+                return;
+            }
+            Launch(*pick);
+        }
+    }
+
+    void Launch(Model& model) {
+        std::vector<Job> batch;
+        Time longest;
+        while (!model.queue.empty() && batch.size() < m_maxBatch) {
+            Job job = model.queue.front();
+            model.queue.pop_front();
+            double wait = (Simulator::Now() - job.queued).GetSeconds();
+            m_waitSum += wait;
+            m_waitMax = std::max(m_waitMax, wait);
+            longest = std::max(longest, m_cameras[job.camera].delay);
+            batch.push_back(job);
+        }
+        m_queued -= batch.size();
+        m_dispatched += batch.size();
+        m_batches++;
+        m_batchSizes[batch.size()]++;
+
+        Time runtime = Seconds(longest.GetSeconds() * (1.0 + model.batchScaling * (batch.size() - 1)));
+        m_busy++;
+        Time busyFrom = std::max(Simulator::Now(), m_windowStart);
+        Time busyTo = std::min(Simulator::Now() + runtime, m_windowStop);
+        if (busyTo > busyFrom) m_busySeconds += (busyTo - busyFrom).GetSeconds();
+        Simulator::Schedule(runtime, &InferenceServer::Complete, this, batch);
+    }
+
+    void Complete(std::vector<Job> batch) {
+        bool inWindow = Simulator::Now() >= m_windowStart && Simulator::Now() <= m_windowStop;
+        for (const Job& job : batch) {
+            Camera& c = m_cameras[job.camera];
+            Ptr<Packet> result = Create<Packet>(c.resultSize);
+            ResultTag tag;
+            tag.cameraId = job.frame.cameraId;
+            tag.frameId = job.frame.frameId;
+            tag.capturedNs = job.frame.capturedNs;
+            result->AddPacketTag(tag);
+            c.tx->Send(result);
+            c.results++;
+            m_completed++;
+            if (inWindow) m_windowCompleted++;
+        }
+        m_busy--;
+        Dispatch();
+    }
+
+    uint32_t m_slots = 1;
+    uint32_t m_queueLimit = 0;
+    uint32_t m_maxBatch = 1;
+    Time m_maxWait;
+
+    std::vector<Camera> m_cameras;
+    std::map<uint32_t, uint32_t> m_index;    // camera id -> m_cameras index
+    std::vector<Model> m_models;
+    std::map<std::string, uint32_t> m_modelIndex;
+    uint64_t m_queued = 0;                   // frames in all model queues
+    uint32_t m_busy = 0;
+    EventId m_wakeup;
+
+    Time m_windowStart, m_windowStop;
+    uint64_t m_received = 0, m_dropped = 0, m_dispatched = 0, m_completed = 0, m_queueMax = 0;
+    uint64_t m_windowCompleted = 0;
+    uint64_t m_batches = 0;
+    std::map<uint32_t, uint64_t> m_batchSizes;
+    double m_waitSum = 0, m_waitMax = 0, m_busySeconds = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(InferenceServer);
+
+// Nearest-rank percentiles of a latency sample (seconds).
+inline nlohmann::json LatencySummary(std::vector<float> v) {
+    if (v.empty()) return {{"results", 0}};
+    std::sort(v.begin(), v.end());
+    auto rank = [&](double q) { return (double)v[std::min(v.size() - 1, (size_t)std::ceil(q * v.size()) - 1)]; };
+    double sum = 0;
+    for (float x : v) sum += x;
+    return {
+        {"results", v.size()},
+        {"mean_s", sum / v.size()},
+        {"p50_s", rank(0.50)},
+        {"p95_s", rank(0.95)},
+        {"p99_s", rank(0.99)},
+        {"max_s", (double)v.back()}
+    };
+}
+
+// Receives the results of any number of cameras, each on its own port, and
+// keeps the end-to-end latency (frame capture to result arrival) of every
+// result. Four bytes per result; percentiles are computed on output only.
+class ResultSinkApp : public Application {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::ResultSinkApp")
+            .SetParent<Application>()
+            .AddConstructor<ResultSinkApp>();
+        return tid;
+    }
+
+    // Call before the application starts.
+    void AddCamera(uint32_t cameraId, uint16_t port) {
+        m_index[cameraId] = m_cameras.size();
+        m_cameras.push_back({cameraId, port});
+    }
+
+    nlohmann::json CameraJson(uint32_t cameraId) const {
+        auto it = m_index.find(cameraId);
+        return it == m_index.end() ? nlohmann::json(nullptr) : LatencySummary(m_cameras[it->second].latency);
+    }
+
+    // All cameras together.
+    nlohmann::json Json() const {
+        std::vector<float> all;
+        for (const Camera& c : m_cameras) all.insert(all.end(), c.latency.begin(), c.latency.end());
+        return LatencySummary(std::move(all));
+    }
+
+private:
+    struct Camera {
+        uint32_t id;
+        uint16_t port;
+        Ptr<Socket> socket;
+        std::vector<float> latency;
+    };
+
+    void StartApplication() override {
+        for (Camera& c : m_cameras) {
+            c.socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+            c.socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), c.port));
+            c.socket->SetRecvCallback(MakeCallback(&ResultSinkApp::Receive, this));
+        }
+    }
+
+    void StopApplication() override {
+        for (Camera& c : m_cameras)
+            if (c.socket) c.socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+
+    void Receive(Ptr<Socket> socket) {
+        while (Ptr<Packet> p = socket->Recv()) {
+            ResultTag tag;
+            if (!p->PeekPacketTag(tag)) continue;
+            auto it = m_index.find(tag.cameraId);
+            if (it == m_index.end()) continue;
+            m_cameras[it->second].latency.push_back((Simulator::Now() - tag.Captured()).GetSeconds());
+        }
+    }
+
+    std::vector<Camera> m_cameras;
+    std::map<uint32_t, uint32_t> m_index;    // camera id -> m_cameras index
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ResultSinkApp);
+
+// One server per processing node, created on first use. start/stop is the
+// measurement window of every server (see InferenceServer::SetWindow).
+class InferenceServers {
+public:
+    InferenceServers(uint32_t slots, uint32_t queueLimit, uint32_t maxBatch, Time maxBatchWait, Time start, Time stop)
+        : m_slots(slots), m_queueLimit(queueLimit), m_maxBatch(maxBatch), m_maxBatchWait(maxBatchWait),
+          m_start(start), m_stop(stop) {}
+
+    // batching: false for servers that only ever see one camera, which would
+    // just wait out MaxBatchWait for frames that cannot come.
+    Ptr<InferenceServer> On(Ptr<Node> node, bool batching) {
+        auto it = m_servers.find(node->GetId());
+        if (it != m_servers.end()) return it->second;
+        Ptr<InferenceServer> server = CreateObject<InferenceServer>();
+        server->SetAttribute("Slots", UintegerValue(m_slots));
+        server->SetAttribute("QueueLimit", UintegerValue(m_queueLimit));
+        if (batching) {
+            server->SetAttribute("MaxBatch", UintegerValue(m_maxBatch));
+            server->SetAttribute("MaxBatchWait", TimeValue(m_maxBatchWait));
+        }
+        server->SetWindow(m_start, m_stop);
+        node->AddApplication(server);
+        server->SetStartTime(Seconds(0));
+        m_servers[node->GetId()] = server;
+        return server;
+    }
+
+    nlohmann::json CameraJson(Ptr<Node> node, uint32_t cameraId) const {
+        auto it = m_servers.find(node->GetId());
+        return it == m_servers.end() ? nlohmann::json(nullptr) : it->second->CameraJson(cameraId);
+    }
+
+    nlohmann::json Json() const {
+        nlohmann::json j = nlohmann::json::array();
+        for (auto& [node, server] : m_servers) {
+            nlohmann::json s = server->Json();
+            s["node"] = node;
+            j.push_back(s);
+        }
+        return j;
+    }
+
+private:
+    uint32_t m_slots, m_queueLimit, m_maxBatch;
+    Time m_maxBatchWait, m_start, m_stop;
+    std::map<uint32_t, Ptr<InferenceServer>> m_servers;    // by node id
+};
+
+} // namespace ns3
+
+#endif // INFERENCE_SERVER_H
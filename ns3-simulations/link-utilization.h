@@ -0,0 +1,319 @@
+#ifndef LINK_UTILIZATION_H
+#define LINK_UTILIZATION_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/wifi-module.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "columnar-file.h"
+#include "flow-stats-writer.h"
+
+namespace ns3 {
+
+/* ================= LINK UTILIZATION ================= */
+// Per-device TX/RX byte counters, sampled every step into a utilization
+// series per link (point-to-point channel) and per BSS:
+//
+//   link  busier direction: bits sent / (DataRate * step)
+//   BSS   transmit airtime of all its members / step; co-channel BSSes
+//         sharing the medium are not added together
+//
+// The report ranks links and BSSes by peak, then mean utilization, and lists
+// the flows crossing the top k. Paths are found after the run by following
+// the routing protocol of every node from source to destination, so there is
+// no per-packet work beyond the byte and airtime counters.
+//
+// The step ending at stop is taken by Finish() after Simulator::Run, since
+// Simulator::Stop for the same time would otherwise pre-empt it.
+
+class LinkUtilization {
+public:
+    using Label = std::function<std::string(uint32_t nodeId)>;
+
+    explicit LinkUtilization(Time step) : m_step(step) {}
+
+    // A BSS: its AP(s) and stations. Call before Install.
+    void AddBss(const std::string& name, const NetDeviceContainer& devices) {
+        Entity e{"bss", name, {}, {}, 0};
+        for (auto it = devices.Begin(); it != devices.End(); ++it) {
+            Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(*it);
+            if (!wifi) continue;
+            e.devices.push_back(AddDevice(wifi, m_entities.size()));
+            e.nodes.push_back(wifi->GetNode()->GetId());
+        }
+        m_entities.push_back(e);
+    }
+
+    // Picks up every point-to-point link between nodes and starts sampling
+    // at step, 2 step, ... up to and including stop (see Finish).
+    void Install(const NodeContainer& nodes, Time stop, Label label) {
+        m_label = label;
+        std::map<Ptr<Channel>, size_t> links;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+            for (uint32_t d = 0; d < (*it)->GetNDevices(); d++) {
+                Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice>((*it)->GetDevice(d));
+                if (!p2p) continue;
+                auto [link, added] = links.emplace(p2p->GetChannel(), m_entities.size());
+                if (added) {
+                    DataRateValue rate;
+                    p2p->GetAttribute("DataRate", rate);
+                    m_entities.push_back({"p2p", "", {}, {}, (double)rate.Get().GetBitRate()});
+                }
+                Entity& e = m_entities[link->second];
+                e.devices.push_back(AddDevice(p2p, link->second));
+                e.nodes.push_back((*it)->GetId());
+            }
+        for (auto& e : m_entities)
+            if (e.kind == "p2p") {
+                for (uint32_t n : e.nodes) e.name += (e.name.empty() ? "" : "-") + m_label(n);
+            }
+
+        m_totalSteps = m_step.IsStrictlyPositive() ? (size_t)(stop.GetSeconds() / m_step.GetSeconds()) : 0;
+        m_util.assign(m_totalSteps * m_entities.size(), 0.0f);
+        m_last.assign(m_devices.size(), Counters());
+        if (m_totalSteps && !m_entities.empty())
+            m_next = Simulator::Schedule(m_step, &LinkUtilization::Sample, this);
+    }
+
+    // Call after Simulator::Run(): takes the sample due at stop.
+    void Finish() {
+        if (m_next.IsExpired() || m_next.GetTs() != (uint64_t)Simulator::Now().GetTimeStep()) return;
+        m_next.Cancel();
+        Sample();
+    }
+
+    // One row per step and link/BSS: time_ns, entity (index in the report's
+    // "entity"), utilization.
+    ColumnarTable Series() const {
+        ColumnarTable t;
+        size_t time = t.AddColumn("time_ns", COL_I64);
+        size_t entity = t.AddColumn("entity", COL_U32);
+        size_t util = t.AddColumn("utilization", COL_F64);
+        for (size_t s = 0; s < m_steps; s++)
+            for (size_t e = 0; e < m_entities.size(); e++) {
+                t.AppendSigned(time, (m_step * (int64_t)(s + 1)).GetNanoSeconds());
+                t.Append(entity, e);
+                t.AppendDouble(util, m_util[s * m_entities.size() + e]);
+            }
+        return t;
+    }
+
+    // Ranked links and BSSes, and the flows crossing the top k of them.
+    nlohmann::json Report(const std::vector<FlowRow>& rows, uint32_t top) const {
+        std::vector<size_t> order(m_entities.size());
+        std::vector<double> peak(order.size(), 0.0), mean(order.size(), 0.0), peakAt(order.size(), 0.0);
+        for (size_t e = 0; e < order.size(); e++) {
+            order[e] = e;
+            for (size_t s = 0; s < m_steps; s++) {
+                double u = m_util[s * order.size() + e];
+                mean[e] += u / m_steps;
+                if (u > peak[e]) { peak[e] = u; peakAt[e] = m_step.GetSeconds() * (s + 1); }
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return peak[a] != peak[b] ? peak[a] > peak[b] : mean[a] > mean[b];
+        });
+
+        nlohmann::json ranked = nlohmann::json::array();
+        std::map<size_t, size_t> hot;   // entity -> index in ranked
+        for (size_t r = 0; r < order.size(); r++) {
+            const Entity& e = m_entities[order[r]];
+            uint64_t tx = 0, rx = 0;
+            for (size_t d : e.devices) { tx += m_devices[d].now.txBytes; rx += m_devices[d].now.rxBytes; }
+            ranked.push_back({
+                {"rank", r + 1}, {"entity", order[r]}, {"kind", e.kind}, {"name", e.name}, {"nodes", e.nodes},
+                {"peak", peak[order[r]]}, {"peak_time_s", peakAt[order[r]]}, {"mean", mean[order[r]]},
+                {"tx_bytes", tx}, {"rx_bytes", rx}
+            });
+            if (e.kind == "p2p") ranked.back()["capacity_bps"] = e.capacity;
+            if (r < top) {
+                hot[order[r]] = r;
+                ranked.back()["flows"] = nlohmann::json::array();
+            }
+        }
+
+        std::map<Ptr<NetDevice>, size_t> entityOf;
+        for (auto& d : m_devices) entityOf[d.device] = d.entity;
+        for (auto& row : rows) {
+            std::vector<size_t> crossed = Crossed(row.tuple, entityOf);
+            for (size_t e : crossed) {
+                auto it = hot.find(e);
+                if (it == hot.end()) continue;
+                double span = (row.stats.timeLastRxPacket - row.stats.timeFirstTxPacket).GetSeconds();
+                ranked[it->second]["flows"].push_back({
+                    {"flow_id", row.flowId},
+                    {"src", NameOf(row.tuple.sourceAddress)},
+                    {"dst", NameOf(row.tuple.destinationAddress)},
+                    {"dst_port", row.tuple.destinationPort},
+                    {"rx_bytes", row.stats.rxBytes},
+                    {"throughput_bps", span > 0 ? row.stats.rxBytes * 8.0 / span : 0.0}
+                });
+            }
+        }
+        for (auto& [e, r] : hot) {
+            auto& flows = ranked[r]["flows"];
+            std::stable_sort(flows.begin(), flows.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+                return a["rx_bytes"].get<uint64_t>() > b["rx_bytes"].get<uint64_t>();
+            });
+        }
+
+        return {{"step_s", m_step.GetSeconds()}, {"samples", m_steps}, {"top", top}, {"links", ranked}};
+    }
+
+private:
+    struct Counters {
+        uint64_t txBytes = 0, rxBytes = 0;
+        Time txBusy;                // Wi-Fi transmit airtime
+    };
+
+    struct Device {
+        Ptr<NetDevice> device;
+        size_t entity;
+        double rate = 0;            // bit/s, point-to-point only
+        Counters now;
+    };
+
+    struct Entity {
+        std::string kind;           // p2p / bss
+        std::string name;
+        std::vector<size_t> devices;
+        std::vector<uint32_t> nodes;
+        double capacity;            // bit/s, p2p only
+    };
+
+    size_t AddDevice(Ptr<PointToPointNetDevice> dev, size_t entity) {
+        size_t i = m_devices.size();
+        DataRateValue rate;
+        dev->GetAttribute("DataRate", rate);
+        m_devices.push_back({dev, entity, (double)rate.Get().GetBitRate(), {}});
+        dev->TraceConnectWithoutContext("PhyTxEnd", MakeBoundCallback(&LinkUtilization::Tx, this, i));
+        dev->TraceConnectWithoutContext("PhyRxEnd", MakeBoundCallback(&LinkUtilization::Rx, this, i));
+        return i;
+    }
+
+    size_t AddDevice(Ptr<WifiNetDevice> dev, size_t entity) {
+        size_t i = m_devices.size();
+        m_devices.push_back({dev, entity, 0, {}});
+        dev->GetMac()->TraceConnectWithoutContext("MacTx", MakeBoundCallback(&LinkUtilization::Tx, this, i));
+        dev->GetMac()->TraceConnectWithoutContext("MacRx", MakeBoundCallback(&LinkUtilization::Rx, this, i));
+        dev->GetPhy()->GetState()->TraceConnectWithoutContext("State",
+                                                             MakeBoundCallback(&LinkUtilization::State, this, i));
+        return i;
+    }
+
+    static void Tx(LinkUtilization* self, size_t i, Ptr<const Packet> p) { self->m_devices[i].now.txBytes += p->GetSize(); }
+    static void Rx(LinkUtilization* self, size_t i, Ptr<const Packet> p) { self->m_devices[i].now.rxBytes += p->GetSize(); }
+
+    static void State(LinkUtilization* self, size_t i, Time, Time duration, WifiPhyState state) {
+        if (state == WifiPhyState::TX) self->m_devices[i].now.txBusy += duration;
+    }
+
+    void Sample() {
+        double step = m_step.GetSeconds();
+        float* util = &m_util[m_steps * m_entities.size()];
+        for (size_t d = 0; d < m_devices.size(); d++) {
+            Device& dev = m_devices[d];
+            Counters& last = m_last[d];
+            float u = dev.rate > 0 ? (float)((dev.now.txBytes - last.txBytes) * 8.0 / (dev.rate * step))
+                                   : (float)((dev.now.txBusy - last.txBusy).GetSeconds() / step);
+            if (m_entities[dev.entity].kind == "p2p")
+                util[dev.entity] = std::max(util[dev.entity], u);
+            else
+                util[dev.entity] += u;
+            last = dev.now;
+        }
+        if (++m_steps < m_totalSteps)
+            m_next = Simulator::Schedule(m_step, &LinkUtilization::Sample, this);
+    }
+
+    uint32_t NodeOf(Ipv4Address addr) const {
+        if (m_owner.empty())
+            for (uint32_t n = 0; n < NodeList::GetNNodes(); n++) {
+                Ptr<Ipv4> ip = NodeList::GetNode(n)->GetObject<Ipv4>();
+                if (!ip) continue;
+                for (uint32_t i = 0; i < ip->GetNInterfaces(); i++)
+                    for (uint32_t a = 0; a < ip->GetNAddresses(i); a++)
+                        m_owner[ip->GetAddress(i, a).GetLocal().Get()] = n;
+            }
+        auto it = m_owner.find(addr.Get());
+        return it == m_owner.end() ? UINT32_MAX : it->second;
+    }
+
+    std::string NameOf(Ipv4Address addr) const {
+        uint32_t node = NodeOf(addr);
+        return node == UINT32_MAX ? "unknown" : m_label(node);
+    }
+
+    // Links and BSSes on the path of a flow, asking each node's routing
+    // protocol for the next hop. The lookup packet carries the flow's ports,
+    // so routing that hashes the 5-tuple (ECMP) picks the flow's own path.
+    std::vector<size_t> Crossed(const Ipv4FlowClassifier::FiveTuple& t,
+                                const std::map<Ptr<NetDevice>, size_t>& entityOf) const {
+        std::vector<size_t> crossed;
+        uint32_t node = NodeOf(t.sourceAddress), dst = NodeOf(t.destinationAddress);
+        Ptr<Packet> packet = Create<Packet>();
+        if (t.protocol == UdpL4Protocol::PROT_NUMBER) {
+            UdpHeader udp;
+            udp.SetSourcePort(t.sourcePort);
+            udp.SetDestinationPort(t.destinationPort);
+            packet->AddHeader(udp);
+        } else if (t.protocol == TcpL4Protocol::PROT_NUMBER) {
+            TcpHeader tcp;
+            tcp.SetSourcePort(t.sourcePort);
+            tcp.SetDestinationPort(t.destinationPort);
+            packet->AddHeader(tcp);
+        }
+        Ipv4Header header;
+        header.SetSource(t.sourceAddress);
+        header.SetDestination(t.destinationAddress);
+        header.SetProtocol(t.protocol);
+        header.SetPayloadSize(packet->GetSize());
+        for (int hop = 0; hop < 64 && node != UINT32_MAX && node != dst; hop++) {
+            Ptr<Ipv4> ip = NodeList::GetNode(node)->GetObject<Ipv4>();
+            Socket::SocketErrno err;
+            Ptr<Ipv4Route> route = ip->GetRoutingProtocol()->RouteOutput(packet, header, nullptr, err);
+            if (!route) break;
+            auto it = entityOf.find(route->GetOutputDevice());
+            if (it != entityOf.end() && std::find(crossed.begin(), crossed.end(), it->second) == crossed.end())
+                crossed.push_back(it->second);
+            Ipv4Address next = route->GetGateway();
+            node = NodeOf(next == Ipv4Address::GetZero() ? t.destinationAddress : next);
+        }
+        return crossed;
+    }
+
+    Time m_step;
+    EventId m_next;
+    Label m_label;
+    std::vector<Device> m_devices;
+    std::vector<Counters> m_last;
+    std::vector<Entity> m_entities;
+    std::vector<float> m_util;      // [step][entity]
+    size_t m_steps = 0, m_totalSteps = 0;
+    mutable std::map<uint32_t, uint32_t> m_owner;   // address -> node id
+};
+
+// Labels nodes as <prefix><index in group>, e.g. {{"camera", cameras}}.
+inline LinkUtilization::Label NodeLabels(const std::vector<std::pair<std::string, NodeContainer>>& groups) {
+    auto names = std::make_shared<std::map<uint32_t, std::string>>();
+    for (auto& [prefix, nodes] : groups)
+        for (uint32_t i = 0; i < nodes.GetN(); i++) (*names)[nodes.Get(i)->GetId()] = prefix + std::to_string(i);
+    return [names](uint32_t id) {
+        auto it = names->find(id);
+        return it == names->end() ? "node" + std::to_string(id) : it->second;
+    };
+}
+
+} // namespace ns3
+
+#endif // LINK_UTILIZATION_H
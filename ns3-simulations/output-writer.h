@@ -0,0 +1,197 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "scenario-archive.h"
+
+/* ================= ASYNC OUTPUT WRITER ================= */
+// Scenario outputs are handed over as self-contained snapshots; a single
+// writer thread renders, writes and optionally fsyncs them while the
+// scenario loop moves on to Simulator::Destroy() and the next topology.
+// Render functions run on the writer thread and must not touch ns-3 objects.
+// The queue is bounded, so a slow filesystem throttles the sweep instead of
+// letting snapshots pile up in memory. A capacity of 0 writes synchronously.
+// Given an archive path, each scenario becomes one archive record instead of
+// a directory of files.
+//
+// A scenario is written completely or not at all: if any file fails to
+// render, nothing is written, and if a write fails the scenario's directory
+// is removed again, so readers never take a partial scenario for a valid
+// one. Outputs are not compressed: flow.bin, the other columnar files and
+// the archive are laid out to be mmapped and read in place by the pipeline,
+// which compression would rule out.
+
+struct OutputFile {
+    std::string name;
+    std::function<std::string()> render;
+};
+
+struct ScenarioOutput {
+    uint32_t scenario;
+    std::string dir;
+    std::vector<OutputFile> files;
+    std::function<void(const ArchiveFiles&)> done;   // after every file was written, optional
+};
+
+class AsyncOutputWriter {
+public:
+    AsyncOutputWriter(size_t capacity, bool fsync, const std::string& archivePath = "")
+        : m_capacity(capacity), m_fsync(fsync) {
+        if (!archivePath.empty()) m_archive.reset(new ScenarioArchiveWriter(archivePath));
+        if (m_capacity > 0) m_thread = std::thread([this] { Run(); });
+    }
+
+    ~AsyncOutputWriter() { Close(); }
+
+    AsyncOutputWriter(const AsyncOutputWriter&) = delete;
+    AsyncOutputWriter& operator=(const AsyncOutputWriter&) = delete;
+
+    // After Close() there is no thread left; outputs are then written inline
+    // rather than queued for nobody.
+    void Submit(ScenarioOutput out) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_capacity == 0 || m_closed) {
+            lock.unlock();
+            Write(out);
+            return;
+        }
+        m_notFull.wait(lock, [this] { return m_queue.size() < m_capacity; });
+        m_queue.push_back(std::move(out));
+        m_notEmpty.notify_one();
+    }
+
+    // Drains the queue and stops the thread. Returns the number of files
+    // that could not be written over the writer's lifetime.
+    uint32_t Close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+        return m_failures;
+    }
+
+private:
+    void Run() {
+        for (;;) {
+            ScenarioOutput out;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notEmpty.wait(lock, [this] { return m_closed || !m_queue.empty(); });
+                if (m_queue.empty()) return;
+                out = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            m_notFull.notify_one();
+            Write(out);
+        }
+    }
+
+    // done only runs when every file was rendered and written; a failed
+    // scenario is reported, left out of the outputs and never handed on
+    // (e.g. into a result cache).
+    void Write(const ScenarioOutput& out) {
+        uint32_t failuresBefore = m_failures;
+        ArchiveFiles rendered;
+        for (auto& f : out.files) {
+            try {
+                rendered.push_back({f.name, f.render()});
+            } catch (const std::exception& e) {
+                std::cerr << out.dir << "/" << f.name << ": " << e.what() << std::endl;
+                m_failures++;
+            }
+        }
+        if (m_failures != failuresBefore) {
+            std::cerr << "scenario " << out.scenario << ": output incomplete, not written" << std::endl;
+            return;
+        }
+
+        if (m_archive) {
+            if (!m_archive->Append(out.scenario, rendered, m_fsync)) {
+                std::cerr << "failed to append scenario " << out.scenario << " to archive" << std::endl;
+                m_failures++;
+            }
+        } else {
+            std::error_code ec;
+            std::filesystem::create_directories(out.dir, ec);
+            for (auto& [name, bytes] : rendered) {
+                if (!WriteFile(out.dir + "/" + name, bytes)) {
+                    std::cerr << "failed to write " << out.dir << "/" << name << std::endl;
+                    m_failures++;
+                    break;
+                }
+            }
+            if (m_failures != failuresBefore) {
+                std::filesystem::remove_all(out.dir, ec);
+                std::cerr << "scenario " << out.scenario << ": output incomplete, " << out.dir
+                          << (ec ? " could not be removed" : " removed") << std::endl;
+            }
+        }
+        if (m_failures != failuresBefore) return;
+        if (out.done) out.done(rendered);
+    }
+
+    // Written to a temporary name and renamed into place, so readers never
+    // see a partial file and hard links (e.g. into a result cache) are
+    // replaced rather than written through.
+    bool WriteFile(const std::string& path, const std::string& bytes) const {
+        std::string tmp = path + ".tmp";
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = write(fd, bytes.data() + done, bytes.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                close(fd);
+                unlink(tmp.c_str());
+                return false;
+            }
+            done += (size_t)n;
+        }
+        if (m_fsync && fsync(fd) != 0) {
+            close(fd);
+            unlink(tmp.c_str());
+            return false;
+        }
+        if (close(fd) != 0 || rename(tmp.c_str(), path.c_str()) != 0) {
+            unlink(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    size_t m_capacity;
+    bool m_fsync;
+    std::unique_ptr<ScenarioArchiveWriter> m_archive;
+    bool m_closed = false;
+    uint32_t m_failures = 0;      // only touched by the writing thread
+
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<ScenarioOutput> m_queue;
+    std::thread m_thread;
+};
+
+#endif // OUTPUT_WRITER_H
@@ -0,0 +1,199 @@
+#ifndef PRUNED_SPECTRUM_CHANNEL_H
+#define PRUNED_SPECTRUM_CHANNEL_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/antenna-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "static-propagation.h"
+
+namespace ns3 {
+
+/* ================= RANGE-PRUNED SPECTRUM CHANNEL ================= */
+// A single-model spectrum channel that only delivers a transmission to PHYs
+// within a fixed interference range of the sender. Static PHYs are kept in a
+// uniform grid whose cell size equals the range, so a transmission inspects
+// the 3 x 3 cells around the sender instead of every attached PHY. PHYs
+// without a ConstantPositionMobilityModel are checked on every transmission,
+// and a mobile sender falls back to scanning all receivers.
+//
+// Receivers are scheduled in attachment order, as SingleModelSpectrumChannel
+// does, so events that tie in time are processed in the same order.
+
+class RangePrunedSpectrumChannel : public SpectrumChannel {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::RangePrunedSpectrumChannel")
+            .SetParent<SpectrumChannel>()
+            .AddConstructor<RangePrunedSpectrumChannel>()
+            .AddAttribute("InterferenceRange",
+                          "Receivers farther than this from the sender (m) get no receive event",
+                          DoubleValue(250.0),
+                          MakeDoubleAccessor(&RangePrunedSpectrumChannel::m_range),
+                          MakeDoubleChecker<double>(1.0));
+        return tid;
+    }
+
+    void AddRx(Ptr<SpectrumPhy> phy) override {
+        if (std::find(m_phys.begin(), m_phys.end(), phy) != m_phys.end()) return;
+        m_phys.push_back(phy);
+        m_indexed = false;
+    }
+
+    void RemoveRx(Ptr<SpectrumPhy> phy) override {
+        auto it = std::find(m_phys.begin(), m_phys.end(), phy);
+        if (it == m_phys.end()) return;
+        m_phys.erase(it);
+        m_indexed = false;
+    }
+
+    std::size_t GetNDevices() const override { return m_phys.size(); }
+
+    Ptr<NetDevice> GetDevice(std::size_t i) const override { return m_phys.at(i)->GetDevice(); }
+
+    void StartTx(Ptr<SpectrumSignalParameters> txParams) override {
+        NS_ASSERT(txParams->txPhy && txParams->psd);
+        if (!m_indexed) BuildIndex();
+
+        m_txSigParamsTrace(txParams->Copy());
+
+        Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility();
+        uint64_t considered = 0;
+
+        for (uint32_t i : Candidates(senderMobility)) {
+            Ptr<SpectrumPhy> rxPhy = m_phys[i];
+            if (rxPhy == txParams->txPhy) continue;
+            considered++;
+
+            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+            Time delay = Seconds(0);
+            Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility();
+
+            if (senderMobility && receiverMobility) {
+                double pathLossDb = 0;
+                if (txParams->txAntenna) {
+                    Angles txAngles(receiverMobility->GetPosition(), senderMobility->GetPosition());
+                    pathLossDb -= txParams->txAntenna->GetGainDb(txAngles);
+                }
+                Ptr<AntennaModel> rxAntenna = DynamicCast<AntennaModel>(rxPhy->GetAntenna());
+                if (rxAntenna) {
+                    Angles rxAngles(senderMobility->GetPosition(), receiverMobility->GetPosition());
+                    pathLossDb -= rxAntenna->GetGainDb(rxAngles);
+                }
+                if (m_propagationLoss)
+                    pathLossDb -= m_propagationLoss->CalcRxPower(0, senderMobility, receiverMobility);
+
+                m_pathLossTrace(txParams->txPhy, rxPhy, pathLossDb);
+                if (pathLossDb > m_maxLossDb) continue;
+
+                *(rxParams->psd) *= std::pow(10.0, -pathLossDb / 10.0);
+                if (m_propagationDelay)
+                    delay = m_propagationDelay->GetDelay(senderMobility, receiverMobility);
+            }
+
+            Ptr<NetDevice> dev = rxPhy->GetDevice();
+            uint32_t context = dev ? dev->GetNode()->GetId() : 0xffffffff;
+            Simulator::ScheduleWithContext(context, delay, &RangePrunedSpectrumChannel::StartRx, rxPhy, rxParams);
+            m_delivered++;
+        }
+        if (m_phys.size() > considered + 1) m_pruned += m_phys.size() - 1 - considered;
+    }
+
+    double GetInterferenceRange() const { return m_range; }
+    uint64_t GetDeliveredCount() const { return m_delivered; }
+    uint64_t GetPrunedCount() const { return m_pruned; }
+
+private:
+    static void StartRx(Ptr<SpectrumPhy> rxPhy, Ptr<SpectrumSignalParameters> params) {
+        rxPhy->StartRx(params);
+    }
+
+    static uint64_t CellKey(int64_t cx, int64_t cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    }
+
+    int64_t Cell(double v) const { return (int64_t)std::floor(v / m_range); }
+
+    // Positions are read once, at the first transmission after the set of
+    // PHYs changed; static nodes are assumed not to be moved afterwards.
+    void BuildIndex() {
+        m_cells.clear();
+        m_unindexed.clear();
+        m_positions.assign(m_phys.size(), Vector());
+        for (uint32_t i = 0; i < m_phys.size(); i++) {
+            Ptr<MobilityModel> mm = m_phys[i]->GetMobility();
+            if (!mm || !DynamicCast<ConstantPositionMobilityModel>(mm)) {
+                m_unindexed.push_back(i);
+                continue;
+            }
+            m_positions[i] = mm->GetPosition();
+            m_cells[CellKey(Cell(m_positions[i].x), Cell(m_positions[i].y))].push_back(i);
+        }
+        m_indexed = true;
+    }
+
+    std::vector<uint32_t> Candidates(Ptr<MobilityModel> sender) const {
+        std::vector<uint32_t> out;
+        if (!sender || !DynamicCast<ConstantPositionMobilityModel>(sender)) {
+            for (uint32_t i = 0; i < m_phys.size(); i++) out.push_back(i);
+            return out;
+        }
+
+        Vector p = sender->GetPosition();
+        int64_t cx = Cell(p.x), cy = Cell(p.y);
+        for (int64_t dx = -1; dx <= 1; dx++) {
+            for (int64_t dy = -1; dy <= 1; dy++) {
+                auto it = m_cells.find(CellKey(cx + dx, cy + dy));
+                if (it == m_cells.end()) continue;
+                for (uint32_t i : it->second)
+                    if (CalculateDistance(p, m_positions[i]) <= m_range) out.push_back(i);
+            }
+        }
+        out.insert(out.end(), m_unindexed.begin(), m_unindexed.end());
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    double m_range = 250.0;
+    std::vector<Ptr<SpectrumPhy>> m_phys;
+    bool m_indexed = false;
+    std::vector<Vector> m_positions;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    std::vector<uint32_t> m_unindexed;
+    uint64_t m_delivered = 0;
+    uint64_t m_pruned = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(RangePrunedSpectrumChannel);
+
+// Log-distance loss and constant-speed delay, the Yans defaults, optionally
+// served from a static table (see static-propagation.h).
+inline Ptr<RangePrunedSpectrumChannel> CreatePrunedSpectrumChannel(double range,
+                                                                   Ptr<StaticPropagationTable>* table) {
+    Ptr<PropagationLossModel> loss;
+    Ptr<PropagationDelayModel> delay;
+    if (table) {
+        *table = CreateStaticPropagation(loss, delay);
+    } else {
+        loss = CreateObject<LogDistancePropagationLossModel>();
+        delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    }
+
+    Ptr<RangePrunedSpectrumChannel> channel = CreateObject<RangePrunedSpectrumChannel>();
+    channel->SetAttribute("InterferenceRange", DoubleValue(range));
+    channel->AddPropagationLossModel(loss);
+    channel->SetPropagationDelayModel(delay);
+    return channel;
+}
+
+} // namespace ns3
+
+#endif // PRUNED_SPECTRUM_CHANNEL_H
@@ -0,0 +1,187 @@
+#ifndef QUEUE_TRACE_H
+#define QUEUE_TRACE_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/wifi-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/* ================= QUEUE OCCUPANCY TRACE ================= */
+// Per-node congestion log: point-to-point TX queues, Wi-Fi MAC queues (every
+// access category) and the root queue disc of every device. Per packet, only
+// the PacketsInQueue traces run, each adding the change to its node's backlog;
+// everything else is read from the queue counters once per step:
+//
+//   queue_size  time-weighted mean packets queued on the node
+//   queue_max   largest backlog seen during the step
+//   throughput  Mbit/s leaving the node's device queues
+//   delay       ms, mean queueing delay by Little's law (backlog / departures)
+//   loss        packets dropped / (dropped + departed)
+//
+// Samples go into an array preallocated for the whole run, and the CSV
+// (network_log.csv) is produced in one piece at the end. The step ending at
+// stop is taken by Finish() after Simulator::Run, since Simulator::Stop for
+// the same time would otherwise pre-empt it.
+
+struct QueueSample {
+    float time;          // end of the step (s)
+    uint32_t nodeId;
+    float queueSize, queueMax;
+    float throughput, delay, loss;
+};
+
+// Formats samples as network_log.csv.
+inline std::string QueueLogCsv(const std::vector<QueueSample>& samples) {
+    std::string out = "time,node_id,queue_size,queue_max,throughput,delay,loss\n";
+    out.reserve(out.size() + samples.size() * 48);
+    char line[128];
+    for (auto& s : samples) {
+        int n = std::snprintf(line, sizeof(line), "%.3f,%u,%.3f,%.0f,%.4f,%.4f,%.5f\n", s.time, s.nodeId,
+                              s.queueSize, s.queueMax, s.throughput, s.delay, s.loss);
+        out.append(line, n);
+    }
+    return out;
+}
+
+class QueueTracer {
+public:
+    explicit QueueTracer(Time step) : m_step(step) {}
+
+    // Hooks the queues of nodes and samples at step, 2 step, ... up to and
+    // including stop (see Finish).
+    // Call after addresses are assigned, which is when queue discs appear.
+    void Install(const NodeContainer& nodes, Time stop) {
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<Node> node = *it;
+            NodeQueues q;
+            q.nodeId = node->GetId();
+            Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+            for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+                Ptr<NetDevice> dev = node->GetDevice(d);
+                if (Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice>(dev)) {
+                    q.device.push_back(p2p->GetQueue());
+                } else if (Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(dev)) {
+                    Ptr<WifiMac> mac = wifi->GetMac();
+                    if (mac->GetQosSupported())
+                        for (AcIndex ac : {AC_BE, AC_BK, AC_VI, AC_VO}) q.device.push_back(mac->GetTxopQueue(ac));
+                    else
+                        q.device.push_back(mac->GetTxopQueue(AC_BE_NQOS));
+                }
+                if (tc)
+                    if (Ptr<QueueDisc> disc = tc->GetRootQueueDiscOnDevice(dev)) q.discs.push_back(disc);
+            }
+            if (q.device.empty() && q.discs.empty()) continue;
+            m_nodes.push_back(q);
+        }
+
+        for (uint32_t i = 0; i < m_nodes.size(); i++) {
+            auto cb = MakeBoundCallback(&QueueTracer::Changed, this, i);
+            for (auto& queue : m_nodes[i].device) queue->TraceConnectWithoutContext("PacketsInQueue", cb);
+            for (auto& disc : m_nodes[i].discs) disc->TraceConnectWithoutContext("PacketsInQueue", cb);
+        }
+
+        m_totalSteps = m_step.IsStrictlyPositive() ? (size_t)std::floor(stop.GetSeconds() / m_step.GetSeconds()) : 0;
+        m_samples.resize(m_totalSteps * m_nodes.size());
+        if (m_totalSteps && !m_nodes.empty()) m_next = Simulator::Schedule(m_step, &QueueTracer::Sample, this);
+    }
+
+    // Call after Simulator::Run(): takes the sample due at stop.
+    void Finish() {
+        if (m_next.IsExpired() || m_next.GetTs() != (uint64_t)Simulator::Now().GetTimeStep()) return;
+        m_next.Cancel();
+        Sample();
+    }
+
+    uint32_t Nodes() const { return m_nodes.size(); }
+    uint64_t Samples() const { return m_written; }
+
+    // Samples in time order.
+    std::vector<QueueSample> Snapshot() const {
+        return std::vector<QueueSample>(m_samples.begin(), m_samples.begin() + m_written);
+    }
+
+private:
+    struct NodeQueues {
+        uint32_t nodeId = 0;
+        std::vector<Ptr<QueueBase>> device;
+        std::vector<Ptr<QueueDisc>> discs;
+
+        int64_t backlog = 0;        // packets queued right now
+        int64_t maxBacklog = 0;     // during the current step
+        double area = 0;            // packet-seconds during the current step
+        Time lastChange;
+
+        // At the last sample. Departed counts what left the device queues
+        // for the link, so packets dropped after dequeue are only losses.
+        uint64_t departedPackets = 0, departedBytes = 0, dropped = 0;
+    };
+
+    static void Changed(QueueTracer* self, uint32_t i, uint32_t oldValue, uint32_t newValue) {
+        NodeQueues& q = self->m_nodes[i];
+        Time now = Simulator::Now();
+        q.area += q.backlog * (now - q.lastChange).GetSeconds();
+        q.lastChange = now;
+        q.backlog += (int64_t)newValue - (int64_t)oldValue;
+        q.maxBacklog = std::max(q.maxBacklog, q.backlog);
+    }
+
+    void Sample() {
+        Time now = Simulator::Now();
+        double step = m_step.GetSeconds();
+        for (auto& q : m_nodes) {
+            q.area += q.backlog * (now - q.lastChange).GetSeconds();
+            q.lastChange = now;
+
+            uint64_t departedPackets = 0, departedBytes = 0, dropped = 0;
+            for (auto& queue : q.device) {
+                departedPackets += queue->GetTotalReceivedPackets() - queue->GetTotalDroppedPacketsBeforeEnqueue() -
+                                   queue->GetTotalDroppedPacketsAfterDequeue() - queue->GetNPackets();
+                departedBytes += queue->GetTotalReceivedBytes() - queue->GetTotalDroppedBytesBeforeEnqueue() -
+                                 queue->GetTotalDroppedBytesAfterDequeue() - queue->GetNBytes();
+                dropped += queue->GetTotalDroppedPackets();
+            }
+            for (auto& disc : q.discs) dropped += disc->GetStats().nTotalDroppedPackets;
+
+            double packets = departedPackets - q.departedPackets;
+            double drops = dropped - q.dropped;
+            double queueSize = q.area / step;
+
+            QueueSample& s = m_samples[m_written++];
+            s.time = (float)now.GetSeconds();
+            s.nodeId = q.nodeId;
+            s.queueSize = (float)queueSize;
+            s.queueMax = (float)q.maxBacklog;
+            s.throughput = (float)((departedBytes - q.departedBytes) * 8.0 / step / 1e6);
+            s.delay = packets > 0 ? (float)(queueSize / (packets / step) * 1e3) : 0.0f;
+            s.loss = drops > 0 ? (float)(drops / (drops + packets)) : 0.0f;
+
+            q.departedPackets = departedPackets;
+            q.departedBytes = departedBytes;
+            q.dropped = dropped;
+            q.area = 0;
+            q.maxBacklog = q.backlog;
+        }
+        if (++m_steps < m_totalSteps)
+            m_next = Simulator::Schedule(m_step, &QueueTracer::Sample, this);
+    }
+
+    Time m_step;
+    EventId m_next;
+    std::vector<NodeQueues> m_nodes;
+    std::vector<QueueSample> m_samples;     // [step][node], sized in Install
+    uint64_t m_written = 0;
+    size_t m_steps = 0, m_totalSteps = 0;
+};
+
+} // namespace ns3
+
+#endif // QUEUE_TRACE_H
@@ -0,0 +1,182 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+/* ================= RESULT CACHE ================= */
+// Content-addressed store of simulation artifacts. An entry lives in
+// <root>/<hash>/ and is keyed by a canonical text description of everything
+// that influences the simulation. The description itself is kept next to the
+// artifacts as key.txt and compared on lookup, so a hash collision is a miss
+// rather than a wrong result. Keys should include BuildFingerprint(), so a
+// rebuilt simulator never serves results of older code.
+
+inline uint64_t Fnv1a64(const std::string& data) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// Identifies the simulation code: a hash of the running executable and of
+// the path, size and modification time of every shared library it has
+// mapped (the ns-3 modules among them), so rebuilding any of them changes
+// every cache key. Linux only; empty if /proc cannot be read, in which case
+// nothing should be cached.
+inline std::string BuildFingerprint() {
+    namespace fs = std::filesystem;
+    std::ifstream exe("/proc/self/exe", std::ios::binary);
+    std::ifstream maps("/proc/self/maps");
+    if (!exe || !maps) return "";
+
+    std::ostringstream bytes;
+    bytes << exe.rdbuf();
+    std::ostringstream libs;
+    libs << std::hex << Fnv1a64(bytes.str());
+
+    std::vector<std::string> seen;
+    std::string line;
+    while (std::getline(maps, line)) {
+        size_t path = line.find('/');
+        if (path == std::string::npos || line.find(".so", path) == std::string::npos) continue;
+        std::string lib = line.substr(path);
+        if (std::find(seen.begin(), seen.end(), lib) != seen.end()) continue;
+        seen.push_back(lib);
+
+        std::error_code ec;
+        auto size = fs::file_size(lib, ec);
+        auto mtime = fs::last_write_time(lib, ec).time_since_epoch().count();
+        libs << "\n" << lib << " " << size << " " << mtime;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << Fnv1a64(libs.str());
+    return os.str();
+}
+
+class ResultCache {
+public:
+    explicit ResultCache(std::string root) : m_root(std::move(root)) {}
+
+    static std::string Hash(const std::string& canonical) {
+        std::ostringstream os;
+        os << std::hex << std::setw(16) << std::setfill('0') << Fnv1a64(canonical);
+        return os.str();
+    }
+
+    // Hard-links (or copies, across filesystems) every cached artifact not
+    // named in `exclude` into dir. Returns false on a miss, leaving dir
+    // untouched.
+    bool Restore(const std::string& canonical, const std::string& dir,
+                 const std::vector<std::string>& exclude = {}) const {
+        namespace fs = std::filesystem;
+        fs::path entry = fs::path(m_root) / Hash(canonical);
+        if (!Matches(entry, canonical)) return false;
+
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        for (auto& f : fs::directory_iterator(entry, ec)) {
+            if (!f.is_regular_file() || f.path().filename() == kKeyFile) continue;
+            if (std::find(exclude.begin(), exclude.end(), f.path().filename()) != exclude.end()) continue;
+            fs::path target = fs::path(dir) / f.path().filename();
+            fs::remove(target, ec);
+            fs::create_hard_link(f.path(), target, ec);
+            if (ec) {
+                fs::copy_file(f.path(), target, fs::copy_options::overwrite_existing, ec);
+                if (ec) return false;
+            }
+        }
+        return true;
+    }
+
+    // Reads every cached artifact into memory, for outputs that do not go
+    // to a directory (e.g. a scenario archive).
+    bool Load(const std::string& canonical,
+              std::vector<std::pair<std::string, std::string>>& files) const {
+        namespace fs = std::filesystem;
+        fs::path entry = fs::path(m_root) / Hash(canonical);
+        if (!Matches(entry, canonical)) return false;
+
+        std::error_code ec;
+        for (auto& f : fs::directory_iterator(entry, ec)) {
+            if (!f.is_regular_file() || f.path().filename() == kKeyFile) continue;
+            std::ifstream in(f.path(), std::ios::binary);
+            std::ostringstream bytes;
+            bytes << in.rdbuf();
+            files.push_back({f.path().filename().string(), bytes.str()});
+        }
+        return !ec;
+    }
+
+    // Reads one cached artifact. False on a miss or if the entry lacks it.
+    bool LoadFile(const std::string& canonical, const std::string& name, std::string& bytes) const {
+        std::filesystem::path entry = std::filesystem::path(m_root) / Hash(canonical);
+        if (!Matches(entry, canonical)) return false;
+        std::ifstream in(entry / name, std::ios::binary);
+        if (!in) return false;
+        std::ostringstream os;
+        os << in.rdbuf();
+        bytes = os.str();
+        return true;
+    }
+
+    // Stores every file except those named in `exclude`. The entry is
+    // assembled in a private directory and renamed into place, so
+    // concurrent sweep workers never observe a half-written entry.
+    void Store(const std::string& canonical,
+               const std::vector<std::pair<std::string, std::string>>& files,
+               const std::vector<std::string>& exclude) const {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::path entry = fs::path(m_root) / Hash(canonical);
+        if (Matches(entry, canonical)) return;
+
+        fs::path tmp = fs::path(m_root) / (".tmp-" + std::to_string(getpid()) + "-" + Hash(canonical));
+        fs::remove_all(tmp, ec);
+        fs::create_directories(tmp, ec);
+        if (ec) return;
+
+        for (auto& [name, bytes] : files) {
+            if (std::find(exclude.begin(), exclude.end(), name) != exclude.end()) continue;
+            std::ofstream out(tmp / name, std::ios::binary);
+            out.write(bytes.data(), bytes.size());
+            if (!out) {
+                fs::remove_all(tmp, ec);
+                return;
+            }
+        }
+        std::ofstream(tmp / kKeyFile, std::ios::binary) << canonical;
+
+        // Fails if another worker stored the same entry first (or on a hash
+        // collision); either way the existing entry is left alone.
+        fs::rename(tmp, entry, ec);
+        if (ec) fs::remove_all(tmp, ec);
+    }
+
+private:
+    static constexpr const char* kKeyFile = "key.txt";
+
+    static bool Matches(const std::filesystem::path& entry, const std::string& canonical) {
+        std::ifstream in(entry / kKeyFile, std::ios::binary);
+        if (!in) return false;
+        std::ostringstream stored;
+        stored << in.rdbuf();
+        return stored.str() == canonical;
+    }
+
+    std::string m_root;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,256 @@
+#ifndef SCENARIO_ARCHIVE_H
+#define SCENARIO_ARCHIVE_H
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* ================= SCENARIO ARCHIVE ================= */
+// One append-only file for a whole sweep instead of a directory per
+// scenario. Layout (all little-endian, every block 8-byte aligned):
+//
+//   header  "SCNARCH1" | u32 version | u32 reserved
+//   record  "SREC" | u32 scenario | u32 nFiles | u32 reserved | u64 bodyLength
+//           nFiles x { u32 nameLength | u32 reserved | u64 dataLength | name | data | pad }
+//   index   "SIDX" | u32 reserved | u64 blockLength
+//           u32 firstScenario | u32 count | count x { u64 offset | u64 length }
+//           u64 indexOffset | "SCNAEND1"
+//
+// Records may be appended by several processes at once (O_APPEND under an
+// exclusive flock). Finalize() scans the records once and appends a dense
+// index keyed by scenario id, so a reader locates any scenario with a single
+// table lookup. Appending after Finalize() is allowed: scans skip the stale
+// index and the next Finalize() writes a fresh one. A later record for the
+// same scenario replaces the earlier one.
+
+using ArchiveFiles = std::vector<std::pair<std::string, std::string>>;
+
+class ScenarioArchiveWriter {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    explicit ScenarioArchiveWriter(std::string path) : m_path(std::move(path)) {}
+
+    // Writes the file header unless the archive already exists.
+    bool Create() const {
+        int fd = OpenLocked(O_RDWR | O_CREAT);
+        if (fd < 0) return false;
+        bool ok = true;
+        if (Size(fd) == 0) {
+            std::string h("SCNARCH1", 8);
+            Put(h, kVersion, 4);
+            Put(h, 0, 4);
+            ok = WriteAll(fd, h);
+        }
+        close(fd);
+        return ok;
+    }
+
+    bool Append(uint32_t scenario, const ArchiveFiles& files, bool sync) const {
+        std::string body;
+        for (auto& [name, data] : files) {
+            Put(body, name.size(), 4);
+            Put(body, 0, 4);
+            Put(body, data.size(), 8);
+            body += name;
+            body += data;
+            body.resize(Align(body.size()), '\0');
+        }
+
+        std::string rec("SREC", 4);
+        Put(rec, scenario, 4);
+        Put(rec, files.size(), 4);
+        Put(rec, 0, 4);
+        Put(rec, body.size(), 8);
+        rec += body;
+
+        int fd = OpenLocked(O_WRONLY | O_APPEND);
+        if (fd < 0) return false;
+        bool ok = WriteAll(fd, rec) && (!sync || fsync(fd) == 0);
+        close(fd);
+        return ok;
+    }
+
+    bool Finalize() const {
+        int fd = OpenLocked(O_RDWR);
+        if (fd < 0) return false;
+
+        uint64_t size = Size(fd);
+        std::map<uint32_t, std::pair<uint64_t, uint64_t>> records;
+        uint64_t pos = kHeaderSize;
+        while (pos + 16 <= size) {
+            uint8_t buf[24] = {};
+            if (pread(fd, buf, sizeof(buf), pos) < 16) break;
+
+            bool isRecord = std::memcmp(buf, "SREC", 4) == 0;
+            if (!isRecord && std::memcmp(buf, "SIDX", 4) != 0) break;
+
+            uint64_t length = isRecord ? 24 + Get(buf + 16, 8) : Get(buf + 8, 8);
+            if (length == 0 || pos + length > size) break;    // torn tail
+
+            if (isRecord)
+                records[(uint32_t)Get(buf + 4, 4)] = {pos, length};
+            pos += length;
+        }
+
+        uint32_t first = records.empty() ? 0 : records.begin()->first;
+        uint32_t count = records.empty() ? 0 : records.rbegin()->first - first + 1;
+
+        std::string idx("SIDX", 4);
+        Put(idx, 0, 4);
+        Put(idx, 16 + 8 + count * 16ull + 16, 8);
+        Put(idx, first, 4);
+        Put(idx, count, 4);
+        for (uint32_t i = 0; i < count; i++) {
+            auto it = records.find(first + i);
+            Put(idx, it == records.end() ? 0 : it->second.first, 8);
+            Put(idx, it == records.end() ? 0 : it->second.second, 8);
+        }
+        Put(idx, pos, 8);
+        idx.append("SCNAEND1", 8);
+
+        // Drop anything unreadable after the last good block.
+        bool ok = ftruncate(fd, pos) == 0 && pwrite(fd, idx.data(), idx.size(), pos) == (ssize_t)idx.size();
+        close(fd);
+        return ok;
+    }
+
+    static constexpr uint64_t kHeaderSize = 16;
+
+    static uint64_t Get(const uint8_t* p, size_t bytes) {
+        uint64_t v = 0;
+        for (size_t b = 0; b < bytes; b++) v |= (uint64_t)p[b] << (8 * b);
+        return v;
+    }
+
+    static uint64_t Align(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+private:
+    int OpenLocked(int flags) const {
+        int fd = open(m_path.c_str(), flags, 0644);
+        if (fd < 0) return -1;
+        while (flock(fd, LOCK_EX) != 0) {
+            if (errno != EINTR) {
+                close(fd);
+                return -1;
+            }
+        }
+        return fd;    // the lock is released by close()
+    }
+
+    static uint64_t Size(int fd) {
+        struct stat st;
+        return fstat(fd, &st) == 0 ? (uint64_t)st.st_size : 0;
+    }
+
+    static void Put(std::string& out, uint64_t value, size_t bytes) {
+        for (size_t b = 0; b < bytes; b++) out.push_back((char)((value >> (8 * b)) & 0xff));
+    }
+
+    static bool WriteAll(int fd, const std::string& bytes) {
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = write(fd, bytes.data() + done, bytes.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            done += (size_t)n;
+        }
+        return true;
+    }
+
+    std::string m_path;
+};
+
+// Read-only, memory-mapped view of a finalized archive. Returned views stay
+// valid for the lifetime of the reader.
+class ScenarioArchiveReader {
+public:
+    explicit ScenarioArchiveReader(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size >= 32) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) {
+                m_data = (const uint8_t*)p;
+                m_size = st.st_size;
+            }
+        }
+        close(fd);
+        if (m_data && !ReadIndex()) Unmap();
+    }
+
+    ~ScenarioArchiveReader() { Unmap(); }
+
+    ScenarioArchiveReader(const ScenarioArchiveReader&) = delete;
+    ScenarioArchiveReader& operator=(const ScenarioArchiveReader&) = delete;
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint32_t FirstScenario() const { return m_first; }
+    uint32_t Count() const { return m_count; }
+
+    bool Has(uint32_t scenario) const { return Entry(scenario) != nullptr; }
+
+    std::vector<std::pair<std::string_view, std::string_view>> Get(uint32_t scenario) const {
+        std::vector<std::pair<std::string_view, std::string_view>> files;
+        const uint8_t* e = Entry(scenario);
+        if (!e) return files;
+
+        uint64_t pos = ScenarioArchiveWriter::Get(e, 8);
+        uint64_t end = pos + ScenarioArchiveWriter::Get(e + 8, 8);
+        uint32_t n = (uint32_t)ScenarioArchiveWriter::Get(m_data + pos + 8, 4);
+        pos += 24;
+        for (uint32_t i = 0; i < n && pos + 16 <= end; i++) {
+            uint64_t nameLen = ScenarioArchiveWriter::Get(m_data + pos, 4);
+            uint64_t dataLen = ScenarioArchiveWriter::Get(m_data + pos + 8, 8);
+            const char* name = (const char*)m_data + pos + 16;
+            files.push_back({{name, nameLen}, {name + nameLen, dataLen}});
+            pos = ScenarioArchiveWriter::Align(pos + 16 + nameLen + dataLen);
+        }
+        return files;
+    }
+
+private:
+    bool ReadIndex() {
+        const uint8_t* footer = m_data + m_size - 16;
+        if (std::memcmp(footer + 8, "SCNAEND1", 8) != 0) return false;
+        uint64_t at = ScenarioArchiveWriter::Get(footer, 8);
+        if (at + 24 > m_size || std::memcmp(m_data + at, "SIDX", 4) != 0) return false;
+        m_first = (uint32_t)ScenarioArchiveWriter::Get(m_data + at + 16, 4);
+        m_count = (uint32_t)ScenarioArchiveWriter::Get(m_data + at + 20, 4);
+        m_index = m_data + at + 24;
+        return at + 24 + m_count * 16ull <= m_size;
+    }
+
+    const uint8_t* Entry(uint32_t scenario) const {
+        if (!m_data || scenario < m_first || scenario - m_first >= m_count) return nullptr;
+        const uint8_t* e = m_index + (scenario - m_first) * 16ull;
+        return ScenarioArchiveWriter::Get(e + 8, 8) ? e : nullptr;
+    }
+
+    void Unmap() {
+        if (m_data) munmap((void*)m_data, m_size);
+        m_data = nullptr;
+    }
+
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+    const uint8_t* m_index = nullptr;
+    uint32_t m_first = 0;
+    uint32_t m_count = 0;
+};
+
+#endif // SCENARIO_ARCHIVE_H
@@ -0,0 +1,126 @@
+#ifndef SIM_PERF_H
+#define SIM_PERF_H
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace ns3 {
+
+/* ================= SIMULATION PERFORMANCE ================= */
+// Wall-clock phases, event count and memory of one scenario, reported in
+// config.json so that modelling options can be compared run against run.
+// Memory figures come from /proc/self/status. The peak (VmHWM) is reset at
+// the start of every scenario where the kernel allows it; otherwise it is
+// the peak of the whole process, so use --jobs > 1 for per-scenario peaks.
+//
+// An optional startup snapshot records events and FlowMonitor totals shortly
+// after the applications start, to separate setup traffic (ARP, association)
+// from steady-state load.
+
+inline uint64_t ProcStatusKb(const char* field) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    size_t n = std::strlen(field);
+    while (std::getline(in, line))
+        if (line.compare(0, n, field) == 0 && line.size() > n && line[n] == ':')
+            return std::stoull(line.substr(n + 1));
+    return 0;
+}
+
+class ScenarioPerf {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ScenarioPerf() : m_start(Clock::now()) {
+        std::ofstream("/proc/self/clear_refs") << "5";   // resets VmHWM
+    }
+
+    // Call right before Simulator::Run() ...
+    void RunStarted() { m_runStart = Clock::now(); }
+
+    // ... and right after it, before Simulator::Destroy().
+    void RunFinished() {
+        m_runEnd = Clock::now();
+        m_events = Simulator::GetEventCount();
+        m_rssKb = ProcStatusKb("VmRSS");
+        m_peakRssKb = ProcStatusKb("VmHWM");
+    }
+
+    // Times one setup step; reported as "<name>_s" together with the RSS it
+    // added as "<name>_rss_kb".
+    template <typename F>
+    void Measure(const std::string& name, F&& step) {
+        uint64_t rss = ProcStatusKb("VmRSS");
+        Clock::time_point t = Clock::now();
+        step();
+        m_steps[name] = {Elapsed(t, Clock::now()), (int64_t)ProcStatusKb("VmRSS") - (int64_t)rss};
+    }
+
+    // Schedules the startup snapshot; call before Simulator::Run().
+    void SnapshotAt(Time at, Ptr<FlowMonitor> monitor) {
+        Simulator::Schedule(at, [this, monitor] {
+            monitor->CheckForLostPackets();
+            uint64_t tx = 0, rx = 0, lost = 0, dropped = 0;
+            for (auto& [id, st] : monitor->GetFlowStats()) {
+                tx += st.txPackets;
+                rx += st.rxPackets;
+                lost += st.lostPackets;
+                for (uint32_t n : st.packetsDropped) dropped += n;
+            }
+            m_startup = {
+                {"time_s", Simulator::Now().GetSeconds()},
+                {"events", Simulator::GetEventCount()},
+                {"tx_packets", tx},
+                {"rx_packets", rx},
+                {"lost_packets", lost},
+                {"dropped_packets", dropped}
+            };
+        });
+    }
+
+    double SetupSeconds() const { return Elapsed(m_start, m_runStart); }
+    double RunSeconds() const { return Elapsed(m_runStart, m_runEnd); }
+    uint64_t Events() const { return m_events; }
+
+    nlohmann::json Json() const {
+        double run = RunSeconds();
+        nlohmann::json j = {
+            {"setup_s", SetupSeconds()},
+            {"run_s", run},
+            {"events", m_events},
+            {"events_per_s", run > 0 ? m_events / run : 0.0},
+            {"rss_kb", m_rssKb},
+            {"peak_rss_kb", m_peakRssKb}
+        };
+        for (auto& [name, step] : m_steps) {
+            j[name + "_s"] = step.first;
+            j[name + "_rss_kb"] = step.second;
+        }
+        if (!m_startup.is_null()) j["startup"] = m_startup;
+        return j;
+    }
+
+private:
+    static double Elapsed(Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    }
+
+    Clock::time_point m_start, m_runStart, m_runEnd;
+    uint64_t m_events = 0;
+    uint64_t m_rssKb = 0;
+    uint64_t m_peakRssKb = 0;
+    std::map<std::string, std::pair<double, int64_t>> m_steps;
+    nlohmann::json m_startup;
+};
+
+} // namespace ns3
+
+#endif // SIM_PERF_H
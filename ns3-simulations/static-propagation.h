@@ -0,0 +1,175 @@
+#ifndef STATIC_PROPAGATION_H
+#define STATIC_PROPAGATION_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/wifi-module.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/* ================= STATIC PROPAGATION TABLE ================= */
+// Loss and delay between nodes that never move are evaluated once, right
+// after mobility is installed, and served from a flat N x N table. Pairs
+// involving a node that is not registered, or whose mobility model is not a
+// ConstantPositionMobilityModel, fall through to the wrapped models.
+//
+// The loss is stored as the gain at 0 dBm transmit power, which is exact for
+// deterministic models that are linear in dB (Friis, log-distance, ...) but
+// not for fading or other randomised models.
+
+class StaticPropagationTable : public SimpleRefCount<StaticPropagationTable> {
+public:
+    // Beyond this the table (8 bytes per ordered pair) is not worth its memory.
+    static const uint32_t kMaxNodes = 4096;
+
+    StaticPropagationTable(Ptr<PropagationLossModel> loss, Ptr<PropagationDelayModel> delay)
+        : m_loss(loss), m_delay(delay) {}
+
+    void Precompute(const NodeContainer& nodes) {
+        std::vector<Ptr<MobilityModel>> mobility;
+        m_index.clear();
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<MobilityModel> mm = (*it)->GetObject<MobilityModel>();
+            if (!mm || !DynamicCast<ConstantPositionMobilityModel>(mm)) continue;
+            if (m_index.count(PeekPointer(mm))) continue;
+            m_index[PeekPointer(mm)] = mobility.size();
+            mobility.push_back(mm);
+        }
+
+        m_n = mobility.size();
+        if (m_n > kMaxNodes) {
+            m_index.clear();
+            m_n = 0;
+        }
+        m_entries.assign((size_t)m_n * m_n, Entry());
+
+        for (uint32_t i = 0; i < m_n; i++) {
+            for (uint32_t j = 0; j < m_n; j++) {
+                if (i == j) continue;
+                Entry& e = m_entries[(size_t)i * m_n + j];
+                e.gainDb = (float)m_loss->CalcRxPower(0.0, mobility[i], mobility[j]);
+                e.delayNs = (uint32_t)m_delay->GetDelay(mobility[i], mobility[j]).GetNanoSeconds();
+            }
+        }
+    }
+
+    uint32_t Size() const { return m_n; }
+
+    double RxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const {
+        const Entry* e = Find(a, b);
+        return e ? txPowerDbm + e->gainDb : m_loss->CalcRxPower(txPowerDbm, a, b);
+    }
+
+    Time Delay(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const {
+        const Entry* e = Find(a, b);
+        return e ? NanoSeconds(e->delayNs) : m_delay->GetDelay(a, b);
+    }
+
+    int64_t AssignStreams(int64_t stream) {
+        return m_loss->AssignStreams(stream) + m_delay->AssignStreams(stream);
+    }
+
+private:
+    struct Entry {
+        float gainDb = 0;
+        uint32_t delayNs = 0;
+    };
+
+    const Entry* Find(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const {
+        if (m_n == 0) return nullptr;
+        auto ia = m_index.find(PeekPointer(a));
+        if (ia == m_index.end()) return nullptr;
+        auto ib = m_index.find(PeekPointer(b));
+        if (ib == m_index.end() || ia->second == ib->second) return nullptr;
+        return &m_entries[(size_t)ia->second * m_n + ib->second];
+    }
+
+    Ptr<PropagationLossModel> m_loss;
+    Ptr<PropagationDelayModel> m_delay;
+    std::unordered_map<const MobilityModel*, uint32_t> m_index;
+    std::vector<Entry> m_entries;
+    uint32_t m_n = 0;
+};
+
+class CachedPropagationLossModel : public PropagationLossModel {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::CachedPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .AddConstructor<CachedPropagationLossModel>();
+        return tid;
+    }
+
+    void SetTable(Ptr<StaticPropagationTable> table) { m_table = table; }
+
+private:
+    double DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override {
+        return m_table->RxPower(txPowerDbm, a, b);
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override { return m_table->AssignStreams(stream); }
+
+    Ptr<StaticPropagationTable> m_table;
+};
+
+class CachedPropagationDelayModel : public PropagationDelayModel {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::CachedPropagationDelayModel")
+            .SetParent<PropagationDelayModel>()
+            .AddConstructor<CachedPropagationDelayModel>();
+        return tid;
+    }
+
+    void SetTable(Ptr<StaticPropagationTable> table) { m_table = table; }
+
+    Time GetDelay(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override {
+        return m_table->Delay(a, b);
+    }
+
+private:
+    int64_t DoAssignStreams(int64_t) override { return 0; }   // streams go through the loss model
+
+    Ptr<StaticPropagationTable> m_table;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationDelayModel);
+
+// Same models as YansWifiChannelHelper::Default() (log-distance loss,
+// constant-speed delay), served through a static table. Call
+// table->Precompute() once node positions are final.
+inline Ptr<StaticPropagationTable> CreateStaticPropagation(Ptr<PropagationLossModel>& loss,
+                                                           Ptr<PropagationDelayModel>& delay) {
+    Ptr<StaticPropagationTable> table = Create<StaticPropagationTable>(
+        CreateObject<LogDistancePropagationLossModel>(), CreateObject<ConstantSpeedPropagationDelayModel>());
+
+    Ptr<CachedPropagationLossModel> cachedLoss = CreateObject<CachedPropagationLossModel>();
+    cachedLoss->SetTable(table);
+    Ptr<CachedPropagationDelayModel> cachedDelay = CreateObject<CachedPropagationDelayModel>();
+    cachedDelay->SetTable(table);
+
+    loss = cachedLoss;
+    delay = cachedDelay;
+    return table;
+}
+
+inline Ptr<YansWifiChannel> CreateStaticYansChannel(Ptr<StaticPropagationTable>& table) {
+    Ptr<PropagationLossModel> loss;
+    Ptr<PropagationDelayModel> delay;
+    table = CreateStaticPropagation(loss, delay);
+
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel>();
+    channel->SetPropagationLossModel(loss);
+    channel->SetPropagationDelayModel(delay);
+    return channel;
+}
+
+} // namespace ns3
+
+#endif // STATIC_PROPAGATION_H
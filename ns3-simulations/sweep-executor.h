@@ -0,0 +1,140 @@
+#ifndef SWEEP_EXECUTOR_H
+#define SWEEP_EXECUTOR_H
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/* ================= SWEEP EXECUTOR ================= */
+// The ns-3 Simulator is a process-wide singleton, so scenarios cannot share a
+// process concurrently. With jobs > 1 every scenario runs in its own forked
+// child, at most `jobs` at a time; the parent never touches the simulator.
+// With jobs == 1 scenarios run in-process, one after the other.
+
+struct ScenarioResult {
+    uint32_t scenario;
+    int status;               // exit code, or -signal if the child was killed
+    std::string outputDir;
+};
+
+inline uint32_t ResolveJobs(uint32_t jobs) {
+    if (jobs > 0) return jobs;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (uint32_t)cores : 1;
+}
+
+inline int StatusOf(int status) {
+    return WIFEXITED(status)   ?  WEXITSTATUS(status) :
+           WIFSIGNALED(status) ? -WTERMSIG(status)    : 1;
+}
+
+inline int RunGuarded(const std::function<int(uint32_t)>& run, uint32_t scenario) {
+    try {
+        return run(scenario);
+    } catch (const std::exception& e) {
+        std::cerr << "scenario " << scenario << " failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "scenario " << scenario << " failed" << std::endl;
+    }
+    return 1;
+}
+
+// Runs scenarios [first, first + scenarioCount), so a sweep can be sharded
+// across machines by giving each one its own range. With jobs > 1, run may
+// also be called in the parent when fork() fails; it must then leave no
+// threads behind, since later scenarios are forked from the parent again.
+// If waiting for children fails, the running ones are killed and reaped, and
+// they and all scenarios not started yet are reported as failed.
+inline std::vector<ScenarioResult> RunScenarioSweep(
+        uint32_t first,
+        uint32_t scenarioCount,
+        uint32_t jobs,
+        const std::function<int(uint32_t)>& run,
+        const std::function<std::string(uint32_t)>& outputDir) {
+
+    std::vector<ScenarioResult> results;
+    results.reserve(scenarioCount);
+    jobs = ResolveJobs(jobs);
+
+    uint32_t last = first + scenarioCount;
+
+    if (jobs == 1) {
+        for (uint32_t scenario = first; scenario < last; scenario++)
+            results.push_back({scenario, RunGuarded(run, scenario), outputDir(scenario)});
+        return results;
+    }
+
+    std::map<pid_t, uint32_t> running;
+    uint32_t next = first;
+
+    while (next < last || !running.empty()) {
+        while (next < last && running.size() < jobs) {
+            // Buffered log output would otherwise be emitted once per child.
+            std::cout.flush();
+            std::clog.flush();
+            std::fflush(nullptr);
+
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::perror("fork");
+                if (running.empty()) {
+                    // Nothing to wait for: degrade to in-process execution.
+                    results.push_back({next, RunGuarded(run, next), outputDir(next)});
+                    next++;
+                }
+                break;
+            }
+            if (pid == 0) {
+                int rc = RunGuarded(run, next);
+                std::cout.flush();
+                std::clog.flush();
+                std::fflush(nullptr);
+                _exit(rc);
+            }
+            running[pid] = next++;
+        }
+
+        if (running.empty()) continue;
+
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            std::perror("waitpid");
+            for (auto& [child, scenario] : running) {
+                kill(child, SIGKILL);
+                int childStatus = 0;
+                pid_t reaped;
+                while ((reaped = waitpid(child, &childStatus, 0)) < 0 && errno == EINTR) {}
+                results.push_back({scenario, reaped == child ? StatusOf(childStatus) : 1, outputDir(scenario)});
+            }
+            running.clear();
+            for (; next < last; next++) results.push_back({next, 1, outputDir(next)});
+            break;
+        }
+
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+
+        results.push_back({it->second, StatusOf(status), outputDir(it->second)});
+        running.erase(it);
+    }
+
+    std::sort(results.begin(), results.end(),
+              [](const ScenarioResult& a, const ScenarioResult& b) { return a.scenario < b.scenario; });
+    return results;
+}
+
+#endif // SWEEP_EXECUTOR_H
@@ -0,0 +1,273 @@
+#ifndef TREE_ROUTING_H
+#define TREE_ROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/* ================= TREE-OF-MESHES ROUTING ================= */
+// Static host routes for a layered topology, installed straight from its
+// structure instead of running SPF over every node:
+//
+//   tier 0 (leaves)  each leaf hangs off one tier-1 node (leafParent)
+//   tier k >= 1      fully meshed with tier k + 1
+//
+// A packet climbs until the destination is reachable downwards (tier >= 2
+// reaches everything below it, a tier-1 node only its own leaves) and then
+// descends. Where several neighbours qualify, the next hop is spread over
+// them per (node, destination), a static form of ECMP. Routes are only
+// installed towards the primary address of the registered destinations, so
+// the cost is O(nodes x destinations) with no all-pairs search.
+//
+// With a hierarchical address plan, PopulateAggregated() instead installs
+// prefix routes whose number is bounded by fan-out: each node reaches its
+// neighbours' own prefixes directly, tiers two or more below it through one
+// aggregate per tier, and everything else through a default route upwards.
+//
+// Links are discovered from the channels of the installed devices: point-to-
+// point channels link their two ends, shared channels (Wi-Fi) link every
+// leaf to its parent only.
+
+class TreeRoutingHelper {
+public:
+    void AddTier(const NodeContainer& nodes) { m_tiers.push_back(nodes); }
+
+    void SetLeafParent(std::function<uint32_t(uint32_t)> parentOf) { m_leafParent = parentOf; }
+
+    void AddDestinations(const NodeContainer& nodes) {
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) m_destinations.push_back(*it);
+    }
+
+    // Prefix owned by a node, e.g. the BSS of an access point.
+    void AddPrefix(Ptr<Node> owner, Ipv4Address network, Ipv4Mask mask) {
+        m_prefixes[owner->GetId()].push_back({network, mask});
+    }
+
+    // Prefix covering the prefixes of every node of a tier.
+    void SetTierAggregate(uint32_t tier, Ipv4Address network, Ipv4Mask mask) {
+        m_aggregates[tier] = {network, mask};
+    }
+
+    // Returns the number of routes installed.
+    uint64_t Populate() {
+        Index();
+        Link();
+
+        Ipv4StaticRoutingHelper helper;
+        uint64_t routes = 0;
+        for (Ptr<Node> dst : m_destinations) {
+            auto d = m_pos.find(dst->GetId());
+            if (d == m_pos.end()) continue;
+            Ipv4Address addr = dst->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+
+            for (uint32_t n = 0; n < m_nodes.size(); n++) {
+                if (n == d->second) continue;
+                const Hop* hop = NextHop(n, d->second);
+                if (!hop) continue;
+                helper.GetStaticRouting(m_nodes[n]->GetObject<Ipv4>())
+                    ->AddHostRouteTo(addr, hop->gateway, hop->ifIndex);
+                routes++;
+            }
+        }
+        return routes;
+    }
+
+    uint64_t PopulateAggregated() {
+        Index();
+        Link();
+
+        Ipv4StaticRoutingHelper helper;
+        uint64_t routes = 0;
+        auto add = [&](uint32_t n, const Prefix& p, const Hop* hop) {
+            if (!hop) return;
+            helper.GetStaticRouting(m_nodes[n]->GetObject<Ipv4>())
+                ->AddNetworkRouteTo(p.network, p.mask, hop->gateway, hop->ifIndex);
+            routes++;
+        };
+
+        for (uint32_t n = 0; n < m_nodes.size(); n++) {
+            for (auto* hops : {&m_up[n], &m_down[n]})
+                for (auto& h : *hops) {
+                    auto own = m_prefixes.find(m_nodes[h.node]->GetId());
+                    if (own == m_prefixes.end()) continue;
+                    for (auto& p : own->second) add(n, p, &h);
+                }
+
+            // Tiers u <= t - 2 hang below the mesh under every down neighbour.
+            std::vector<const Hop*> down = Pointers(m_down[n]);
+            for (uint32_t u = 1; u + 2 <= m_tier[n]; u++) {
+                auto agg = m_aggregates.find(u);
+                if (agg != m_aggregates.end()) {
+                    add(n, agg->second, Spread(down, n, u));
+                    continue;
+                }
+                for (uint32_t d = 0; d < m_nodes.size(); d++) {
+                    if (m_tier[d] != u) continue;
+                    auto own = m_prefixes.find(m_nodes[d]->GetId());
+                    if (own == m_prefixes.end()) continue;
+                    for (auto& p : own->second) add(n, p, Spread(down, n, d));
+                }
+            }
+
+            add(n, {Ipv4Address::GetZero(), Ipv4Mask::GetZero()}, Spread(Pointers(m_up[n]), n, 0));
+        }
+        return routes;
+    }
+
+private:
+    struct Prefix {
+        Ipv4Address network;
+        Ipv4Mask mask;
+    };
+
+    struct Hop {
+        uint32_t node;        // index into m_nodes
+        uint32_t ifIndex;     // outgoing interface on the local node
+        Ipv4Address gateway;  // neighbour's address on that link
+    };
+
+    void Index() {
+        m_nodes.clear();
+        m_tier.clear();
+        m_rank.clear();
+        m_pos.clear();
+        for (uint32_t t = 0; t < m_tiers.size(); t++) {
+            for (uint32_t i = 0; i < m_tiers[t].GetN(); i++) {
+                Ptr<Node> node = m_tiers[t].Get(i);
+                m_pos[node->GetId()] = m_nodes.size();
+                m_nodes.push_back(node);
+                m_tier.push_back(t);
+                m_rank.push_back(i);
+            }
+        }
+        m_up.assign(m_nodes.size(), {});
+        m_down.assign(m_nodes.size(), {});
+        m_parent.assign(m_nodes.size(), UINT32_MAX);
+        for (uint32_t n = 0; n < m_nodes.size(); n++)
+            if (m_tier[n] == 0 && m_leafParent && m_tiers.size() > 1)
+                m_parent[n] = m_pos[m_tiers[1].Get(m_leafParent(m_rank[n]))->GetId()];
+    }
+
+    void Link() {
+        struct Attachment { uint32_t node; uint32_t ifIndex; Ipv4Address addr; };
+        std::map<Ptr<Channel>, std::vector<Attachment>> channels;
+        for (uint32_t n = 0; n < m_nodes.size(); n++) {
+            Ptr<Ipv4> ipv4 = m_nodes[n]->GetObject<Ipv4>();
+            for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++) {
+                Ptr<Channel> ch = ipv4->GetNetDevice(i)->GetChannel();
+                if (ch && ipv4->GetNAddresses(i) > 0)
+                    channels[ch].push_back({n, i, ipv4->GetAddress(i, 0).GetLocal()});
+            }
+        }
+
+        for (auto& [ch, att] : channels) {
+            if (att.size() == 2) {
+                Connect(att[0].node, att[0].ifIndex, att[1].node, att[1].addr);
+                Connect(att[1].node, att[1].ifIndex, att[0].node, att[0].addr);
+                continue;
+            }
+            std::map<uint32_t, const Attachment*> byNode;
+            for (auto& a : att) byNode[a.node] = &a;
+            for (auto& a : att) {
+                if (m_parent[a.node] == UINT32_MAX) continue;
+                auto p = byNode.find(m_parent[a.node]);
+                if (p == byNode.end()) continue;
+                Connect(a.node, a.ifIndex, p->second->node, p->second->addr);
+                Connect(p->second->node, p->second->ifIndex, a.node, a.addr);
+            }
+        }
+    }
+
+    void Connect(uint32_t from, uint32_t ifIndex, uint32_t to, Ipv4Address gateway) {
+        if (m_tier[to] == m_tier[from] + 1) m_up[from].push_back({to, ifIndex, gateway});
+        else if (m_tier[to] + 1 == m_tier[from]) m_down[from].push_back({to, ifIndex, gateway});
+    }
+
+    bool ReachableDown(uint32_t n, uint32_t d) const {
+        if (m_tier[n] <= m_tier[d]) return false;
+        if (m_tier[n] >= 2) return true;
+        return m_parent[d] == n;    // tier 1 only reaches its own leaves
+    }
+
+    static std::vector<const Hop*> Pointers(const std::vector<Hop>& hops) {
+        std::vector<const Hop*> out;
+        for (auto& h : hops) out.push_back(&h);
+        return out;
+    }
+
+    const Hop* Spread(const std::vector<const Hop*>& hops, uint32_t n, uint32_t d) const {
+        return hops.empty() ? nullptr : hops[(n + d) % hops.size()];
+    }
+
+    const Hop* NextHop(uint32_t n, uint32_t d) const {
+        for (auto& h : m_up[n]) if (h.node == d) return &h;
+        for (auto& h : m_down[n]) if (h.node == d) return &h;
+
+        std::vector<const Hop*> hops;
+        if (ReachableDown(n, d)) {
+            for (auto& h : m_down[n])
+                if (ReachableDown(h.node, d)) hops.push_back(&h);
+        } else {
+            hops = Pointers(m_up[n]);
+        }
+        return Spread(hops, n, d);
+    }
+
+    std::vector<NodeContainer> m_tiers;
+    std::function<uint32_t(uint32_t)> m_leafParent;
+    std::vector<Ptr<Node>> m_destinations;
+    std::map<uint32_t, std::vector<Prefix>> m_prefixes;   // by node id
+    std::map<uint32_t, Prefix> m_aggregates;              // by tier
+
+    std::vector<Ptr<Node>> m_nodes;
+    std::vector<uint32_t> m_tier, m_rank, m_parent;
+    std::map<uint32_t, uint32_t> m_pos;    // node id -> index
+    std::vector<std::vector<Hop>> m_up, m_down;
+};
+
+// Binds every leaf to its parent for leaves whose link layer does not choose
+// an access point itself (ad hoc Wi-Fi): a default route plus host routes to
+// the primary address of every destination, all via the parent's primary
+// address. The host routes matter with flat addressing, where every
+// destination would otherwise be on-link and reached directly. The leaf's
+// first interface must face the parent.
+inline void SetLeafGateways(const NodeContainer& leaves, const NodeContainer& parents,
+                            std::function<uint32_t(uint32_t)> parentOf, const NodeContainer& destinations) {
+    Ipv4StaticRoutingHelper helper;
+    for (uint32_t i = 0; i < leaves.GetN(); i++) {
+        Ptr<Ipv4StaticRouting> routing = helper.GetStaticRouting(leaves.Get(i)->GetObject<Ipv4>());
+        if (!routing) continue;
+        Ipv4Address gateway = parents.Get(parentOf(i))->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+        routing->SetDefaultRoute(gateway, 1);
+        for (auto it = destinations.Begin(); it != destinations.End(); ++it) {
+            Ipv4Address dst = (*it)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+            if (dst != gateway) routing->AddHostRouteTo(dst, gateway, 1);
+        }
+    }
+}
+
+// Routes held by the static and global routing protocols of the given nodes.
+inline uint64_t CountRoutes(const NodeContainer& nodes) {
+    uint64_t routes = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+        Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>((*it)->GetObject<Ipv4>()->GetRoutingProtocol());
+        if (!list) continue;
+        for (uint32_t i = 0; i < list->GetNRoutingProtocols(); i++) {
+            int16_t priority;
+            Ptr<Ipv4RoutingProtocol> proto = list->GetRoutingProtocol(i, priority);
+            if (auto s = DynamicCast<Ipv4StaticRouting>(proto)) routes += s->GetNRoutes();
+            else if (auto g = DynamicCast<Ipv4GlobalRouting>(proto)) routes += g->GetNRoutes();
+        }
+    }
+    return routes;
+}
+
+} // namespace ns3
+
+#endif // TREE_ROUTING_H
@@ -6,14 +6,34 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
+#include "ns3/nix-vector-routing-module.h"
 
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <memory>
 #include <vector>
+#include <set>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 
+#include "sweep-executor.h"
+#include "flow-stats-writer.h"
+#include "camera-flow-join.h"
+#include "output-writer.h"
+#include "result-cache.h"
+#include "static-propagation.h"
+#include "sim-perf.h"
+#include "address-plan.h"
+#include "tree-routing.h"
+#include "channel-plan.h"
+#include "camera-apps.h"
+#include "inference-server.h"
+#include "flow-sketch.h"
+#include "flow-timeseries.h"
+#include "queue-trace.h"
+#include "link-utilization.h"
+
 using namespace ns3;
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -34,6 +54,44 @@ struct CameraConfig {
     uint32_t resultSize;      // bytes
 };
 
+/* ================= SCENARIO CONSTANTS ================= */
+
+const std::string kP2pDataRate = "10Gbps";
+const std::string kP2pDelay    = "5ms";
+const double kAppStart = 1.0;    // seconds
+const double kAppStop  = 20.0;
+const double kSimStop  = 22.0;
+
+struct ScenarioOptions {
+    uint32_t seed;            // ns-3 RngSeed
+    uint64_t run;             // ns-3 RngRun, identical for every scenario
+    bool useCache;
+    std::string cacheDir;
+    std::string build;        // BuildFingerprint(), part of every cache key
+    std::string flowFormat;   // xml / columnar / both
+    bool flowSketch;          // per-flow delay/jitter sketches (flow_sketch.bin, flow_tails.bin)
+    double sketchAlpha;       // relative accuracy of the sketches
+    double sampleStep;        // flow time series step (s, timeseries.bin); 0 = off
+    double queueStep;         // queue occupancy log step (s, network_log.csv); 0 = off
+    double linkStep;          // link/BSS utilization step (s, link_util.bin, link_report.json); 0 = off
+    uint32_t hotLinks;        // links in the report that list their flows
+    std::string archive;      // scenario archive path; empty = one directory per scenario
+    bool staticChannel;       // serve Wi-Fi loss/delay from a precomputed table
+    std::string monitor;      // all / endpoints
+    std::string addressing;   // flat / hier
+    std::string routing;      // global / nix
+    bool populateArp;         // fill neighbour caches before the run
+    bool fastAssociate;       // ad hoc Wi-Fi, camera bound to its edgeId AP by routing
+    std::string bss;          // shared / perAp
+    std::string channelPlan;  // unique / 2.4 / 5 / dual, perAp only
+    std::string cameraApp;    // onoff / frames
+    std::string inference;    // open / server, server needs frames
+    uint32_t computeSlots;    // per InferenceServer
+    uint32_t queueLimit;      // frames waiting per InferenceServer, 0 = unbounded
+    uint32_t batchMax;        // frames per inference batch
+    double batchWait;         // seconds a partial batch may wait to fill
+};
+
 /* ================= UTILS ================= */
 
 double GetInferenceDelay(const std::string& model) {
@@ -42,177 +100,718 @@ double GetInferenceDelay(const std::string& model) {
     return 0.12; // heavy
 }
 
+// Marginal cost of one more frame in an inference batch, relative to one
+// frame alone: larger models saturate the accelerator sooner.
+double GetBatchScaling(const std::string& model) {
+    if (model == "small") return 0.1;
+    if (model == "medium") return 0.2;
+    return 0.35; // heavy
+}
+
 uint32_t GetResultSize(const std::string& model) {
     if (model == "small") return 200;
     if (model == "medium") return 500;
     return 1200;
 }
 
-/* ================= MAIN ================= */
-
-int main(int argc, char *argv[]) {
-
-    Time::SetResolution(Time::NS);
-    LogComponentEnable("WarehouseSimulation", LOG_LEVEL_INFO);
+std::string ScenarioDir(uint32_t scenario) {
+    std::ostringstream dir;
+    dir << "outputs/scenario_" << std::setw(3) << std::setfill('0') << scenario;
+    return dir.str();
+}
 
-    uint32_t scenarioCount = 100;
-    CommandLine cmd;
-    cmd.AddValue("scenarios", "Number of scenarios", scenarioCount);
-    cmd.Parse(argc, argv);
+// Canonical description of everything that influences a scenario's
+// simulation, used as the result cache key. The scenario index is
+// deliberately absent: scenarios with equal parameters share one entry.
+std::string DescribeScenario(uint32_t numCameras, uint32_t numEdges, uint32_t numClouds,
+                             const std::vector<CameraConfig>& configs,
+                             const ScenarioOptions& opts) {
+    std::ostringstream os;
+    os << std::setprecision(17);
+    os << "warehouse " << opts.build << "\n"
+       << "nodes " << numCameras << " " << numEdges << " " << numClouds << " 1\n"
+       << "wifi 80211n warehouse " << (opts.staticChannel ? "static" : "yans")
+       << (opts.fastAssociate ? " adhoc" : " infrastructure") << " bss " << opts.bss
+       << " channels " << opts.channelPlan << "\n"
+       << "p2p " << kP2pDataRate << " " << kP2pDelay << "\n"
+       << "addressing " << opts.addressing << " routing " << opts.routing
+       << " arp " << (opts.populateArp ? "static" : "dynamic") << "\n"
+       << "apps " << opts.cameraApp << " inference " << opts.inference
+       << " " << opts.computeSlots << " " << opts.queueLimit
+       << " batch " << opts.batchMax << " " << opts.batchWait << "\n"
+       << "time " << kAppStart << " " << kAppStop << " " << kSimStop << "\n"
+       << "rng " << opts.seed << " " << opts.run << "\n"
+       << "output " << opts.flowFormat << " monitor " << opts.monitor
+       << " sketch " << (opts.flowSketch ? opts.sketchAlpha : 0.0) << " sample " << opts.sampleStep
+       << " queues " << opts.queueStep << " links " << opts.linkStep << " " << opts.hotLinks << "\n";
+    for (auto &c : configs)
+        os << "camera " << c.id << " " << c.edgeId << " " << c.cloudId << " "
+           << c.processing << " " << c.model << " " << c.frameSize << " "
+           << c.frameInterval << " " << c.inferenceDelay << " " << c.resultSize << "\n";
+    return os.str();
+}
 
-    // Create top-level outputs folder
-    fs::create_directories("outputs");
+json ConfigJson(uint32_t scenario, const std::vector<CameraConfig>& configs) {
+    json meta;
+    meta["scenario"] = scenario;
+    meta["cameras"] = json::array();
+    for (auto &c : configs)
+        meta["cameras"].push_back({
+            {"id", c.id},
+            {"processing", c.processing},
+            {"model", c.model},
+            {"inference_delay", c.inferenceDelay},
+            {"result_size", c.resultSize}
+        });
+    return meta;
+}
 
-    for (uint32_t scenario = 0; scenario < scenarioCount; scenario++) {
+/* ================= SCENARIO ================= */
 
-        NS_LOG_INFO("Running scenario " << scenario);
+int RunScenario(uint32_t scenario, const ScenarioOptions& opts, AsyncOutputWriter& writer) {
 
-        uint32_t numCameras = 6 + (scenario % 5);   // 6–10 cameras
-        uint32_t numEdges   = 2 + (scenario % 2);   // 2–3 edges
-        uint32_t numClouds  = 2;
+    NS_LOG_INFO("Running scenario " << scenario);
 
-        NodeContainer cameras, edges, clouds, control;
-        cameras.Create(numCameras);
-        edges.Create(numEdges);
-        clouds.Create(numClouds);
-        control.Create(1);
+    uint32_t numCameras = 6 + (scenario % 5);   // 6–10 cameras
+    uint32_t numEdges   = 2 + (scenario % 2);   // 2–3 edges
+    uint32_t numClouds  = 2;
 
-        NodeContainer all;
-        all.Add(cameras);
-        all.Add(edges);
-        all.Add(clouds);
-        all.Add(control);
+    /* ================= CAMERA CONFIG ================= */
+    std::vector<CameraConfig> configs;
 
-        /* ================= WIFI (CAM → EDGE) ================= */
-        WifiHelper wifi;
-        wifi.SetStandard(WIFI_STANDARD_80211n);
+    for (uint32_t i = 0; i < numCameras; i++) {
+        std::string model = (i % 3 == 0) ? "heavy" : (i % 2 ? "medium" : "small");
+        std::string proc  = (i % 3 == 0) ? "cloud" : (i % 2 ? "edge" : "camera");
 
-        YansWifiPhyHelper phy;
-        YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-        phy.SetChannel(channel.Create());
+        configs.push_back({
+            i,
+            i % numEdges,
+            i % numClouds,
+            proc,
+            model,
+            1500,
+            0.1,
+            GetInferenceDelay(model),
+            GetResultSize(model)
+        });
+    }
 
-        WifiMacHelper mac;
-        Ssid ssid("warehouse");
+    /* ================= RESULT CACHE ================= */
+    std::string dir = ScenarioDir(scenario);
+    ResultCache cache(opts.cacheDir);
+    std::string key = DescribeScenario(numCameras, numEdges, numClouds, configs, opts);
+
+    // The cached config.json is the full meta without the scenario index,
+    // which is stamped back in here; perf is that of the run that computed
+    // the entry, marked as cached.
+    if (opts.useCache) {
+        ArchiveFiles cached;
+        std::string config;
+        bool hit;
+        if (opts.archive.empty()) {
+            // Like a miss, start from an empty directory, so no file of an
+            // earlier run (e.g. in another --flowFormat) survives next to
+            // the restored ones.
+            hit = cache.LoadFile(key, "config.json", config);
+            if (hit) {
+                fs::remove_all(dir);
+                hit = cache.Restore(key, dir, {"config.json"});
+            }
+        } else {
+            hit = cache.Load(key, cached);
+        }
+        for (auto it = cached.begin(); it != cached.end(); ++it)
+            if (it->first == "config.json") {
+                config = std::move(it->second);
+                cached.erase(it);
+                break;
+            }
+        json meta = json::parse(config, nullptr, false);
+        if (hit && meta.is_object()) {
+            NS_LOG_INFO("Scenario " << scenario << " served from cache " << ResultCache::Hash(key));
+            meta["scenario"] = scenario;
+            meta["perf"]["cached"] = true;
+            ScenarioOutput out{scenario, dir, {{"config.json", [meta] { return meta.dump(4); }}}, nullptr};
+            for (auto &[name, bytes] : cached)
+                out.files.push_back({name, [bytes = std::move(bytes)] { return bytes; }});
+            writer.Submit(std::move(out));
+            return 0;
+        }
+    }
 
-        mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
-        NetDeviceContainer camDevs = wifi.Install(phy, mac, cameras);
+    ScenarioPerf perf;
+    RngSeedManager::SetSeed(opts.seed);
+    RngSeedManager::SetRun(opts.run);
+    RngSeedManager::ResetNextStreamIndex();
+
+    NodeContainer cameras, edges, clouds, control;
+    cameras.Create(numCameras);
+    edges.Create(numEdges);
+    clouds.Create(numClouds);
+    control.Create(1);
+
+    NodeContainer all;
+    all.Add(cameras);
+    all.Add(edges);
+    all.Add(clouds);
+    all.Add(control);
+
+    /* ================= WIFI (CAM → EDGE) ================= */
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211n);
+
+    // shared: one SSID and one channel object for every camera and edge.
+    // perAp: edge j and the cameras with edgeId j form their own BSS with
+    // its own SSID and channel object, so BSSes neither contend nor interfere.
+    uint32_t numBss = (opts.bss == "perAp") ? numEdges : 1;
+    std::vector<uint32_t> mediumOf(numBss);
+    for (uint32_t b = 0; b < numBss; b++) mediumOf[b] = b;
+    uint32_t numMedia = numBss;
+
+    // Planned channels: BSSes are coloured with the real channels of the
+    // chosen bands, and all BSSes on one channel share one channel object.
+    // Every Wi-Fi node sits at the origin (see MOBILITY below).
+    ChannelPlan plan;
+    std::vector<uint32_t> mediumChannel;
+    if (opts.channelPlan != "unique") {
+        std::vector<std::vector<Vector>> members(numBss, {Vector(0.0, 0.0, 0.0)});
+        double range = InterferenceRange(CreateObject<LogDistancePropagationLossModel>(),
+                                         kWifiTxPowerDbm, kWifiCcaDbm);
+        plan = PlanChannels(members, range, AvailableChannels(opts.channelPlan));
+        mediumChannel = plan.Used(mediumOf);
+        numMedia = mediumChannel.size();
+    }
 
-        mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
-        NetDeviceContainer edgeDevs = wifi.Install(phy, mac, edges);
+    std::vector<Ptr<YansWifiChannel>> channels;
+    std::vector<Ptr<StaticPropagationTable>> propagation(numMedia);
+    for (uint32_t m = 0; m < numMedia; m++) {
+        if (opts.staticChannel)
+            channels.push_back(CreateStaticYansChannel(propagation[m]));
+        else
+            channels.push_back(YansWifiChannelHelper::Default().Create());
+    }
 
-        /* ================= EDGE ↔ CLOUD ↔ CONTROL (P2P) ================= */
-        PointToPointHelper p2p;
-        p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
-        p2p.SetChannelAttribute("Delay", StringValue("5ms"));
+    std::vector<NodeContainer> mediumNodes(numMedia);
+    std::vector<Ptr<NetDevice>> camDev(numCameras), edgeDev(numEdges);
+    std::vector<NetDeviceContainer> bssDevs(numBss);
 
-        NetDeviceContainer p2pDevs;
-        for (uint32_t i = 0; i < numEdges; i++)
-            for (uint32_t j = 0; j < numClouds; j++)
-                p2pDevs.Add(p2p.Install(edges.Get(i), clouds.Get(j)));
+    for (uint32_t b = 0; b < numBss; b++) {
+        YansWifiPhyHelper phy;
+        phy.SetChannel(channels[mediumOf[b]]);
+        if (!mediumChannel.empty())
+            phy.Set("ChannelSettings", StringValue(plan.channels[mediumChannel[mediumOf[b]]].Settings()));
 
-        p2pDevs.Add(p2p.Install(clouds.Get(0), control.Get(0)));
+        std::vector<uint32_t> camIds, edgeIds;
+        for (auto &c : configs)
+            if (numBss == 1 || c.edgeId == b) camIds.push_back(c.id);
+        for (uint32_t j = 0; j < numEdges; j++)
+            if (numBss == 1 || j == b) edgeIds.push_back(j);
+
+        NodeContainer bssCams, bssEdges;
+        for (uint32_t i : camIds) bssCams.Add(cameras.Get(i));
+        for (uint32_t j : edgeIds) bssEdges.Add(edges.Get(j));
+        mediumNodes[mediumOf[b]].Add(bssCams);
+        mediumNodes[mediumOf[b]].Add(bssEdges);
+
+        // fastAssociate: ns-3 cannot start a StaWifiMac associated, so cameras
+        // and edges run ad hoc MACs (no beacons, probes or association) and
+        // each camera reaches its edgeId edge through a default route instead.
+        WifiMacHelper mac;
+        Ssid ssid(numBss == 1 ? "warehouse" : "warehouse-" + std::to_string(b));
+
+        if (opts.fastAssociate)
+            mac.SetType("ns3::AdhocWifiMac");
+        else
+            mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+        NetDeviceContainer devs = wifi.Install(phy, mac, bssCams);
+        for (size_t k = 0; k < camIds.size(); k++) camDev[camIds[k]] = devs.Get(k);
+        bssDevs[b].Add(devs);
+
+        if (!opts.fastAssociate)
+            mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+        devs = wifi.Install(phy, mac, bssEdges);
+        for (size_t k = 0; k < edgeIds.size(); k++) edgeDev[edgeIds[k]] = devs.Get(k);
+        bssDevs[b].Add(devs);
+    }
 
-        InternetStackHelper stack;
-        stack.Install(all);
+    NetDeviceContainer camDevs, edgeDevs;
+    for (auto &d : camDev) camDevs.Add(d);
+    for (auto &d : edgeDev) edgeDevs.Add(d);
+
+    /* ================= EDGE ↔ CLOUD ↔ CONTROL (P2P) ================= */
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(kP2pDataRate));
+    p2p.SetChannelAttribute("Delay", StringValue(kP2pDelay));
+
+    // Links are also kept grouped by their upper node for hierarchical addressing.
+    NetDeviceContainer p2pDevs;
+    std::vector<std::vector<NetDeviceContainer>> cloudLinks(numClouds);
+    for (uint32_t i = 0; i < numEdges; i++) {
+        for (uint32_t j = 0; j < numClouds; j++) {
+            NetDeviceContainer link = p2p.Install(edges.Get(i), clouds.Get(j));
+            p2pDevs.Add(link);
+            cloudLinks[j].push_back(link);
+        }
+    }
 
+    NetDeviceContainer controlLink = p2p.Install(clouds.Get(0), control.Get(0));
+    p2pDevs.Add(controlLink);
+
+    InternetStackHelper stack;
+    Ipv4NixVectorHelper nix;
+    if (opts.routing == "nix")
+        stack.SetRoutingHelper(nix);
+    perf.Measure("stack", [&] { stack.Install(all); });
+
+    // hier: one block per BSS (a single one when all edges serve the same
+    // SSID), a /24 of /30s per cloud for its edge links, and one for the
+    // control link. Routing stays global; it installs per-subnet routes.
+    if (opts.addressing == "hier") {
+        if (numBss == 1) {
+            AssignBss(BssSubnet(0, numCameras + numEdges), edgeDevs, camDevs);
+        } else {
+            std::vector<NetDeviceContainer> stations(numEdges);
+            for (auto &c : configs) stations[c.edgeId].Add(camDevs.Get(c.id));
+            uint32_t largest = 0;
+            for (auto &s : stations) largest = std::max(largest, s.GetN());
+            for (uint32_t j = 0; j < numEdges; j++)
+                AssignBss(BssSubnet(j, largest), NetDeviceContainer(edgeDevs.Get(j)), stations[j]);
+        }
+        for (uint32_t j = 0; j < numClouds; j++)
+            AssignLinks(LinkGroupSubnet(2, j), cloudLinks[j]);
+        AssignLinks(LinkGroupSubnet(3, 0), {controlLink});
+    } else {
         Ipv4AddressHelper addr;
         addr.SetBase("10.0.0.0", "255.255.0.0");
         addr.Assign(camDevs);
         addr.Assign(edgeDevs);
         addr.Assign(p2pDevs);
+    }
 
-        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
-
-        /* ================= MOBILITY ================= */
-        MobilityHelper mob;
-        mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-        mob.Install(all);
-
-        /* ================= CAMERA CONFIG ================= */
-        std::vector<CameraConfig> configs;
-
-        for (uint32_t i = 0; i < numCameras; i++) {
-            std::string model = (i % 3 == 0) ? "heavy" : (i % 2 ? "medium" : "small");
-            std::string proc  = (i % 3 == 0) ? "cloud" : (i % 2 ? "edge" : "camera");
-
-            configs.push_back({
-                i,
-                i % numEdges,
-                i % numClouds,
-                proc,
-                model,
-                1500,
-                0.1,
-                GetInferenceDelay(model),
-                GetResultSize(model)
-            });
+    // nix computes paths on first use and caches them per node, so its cost
+    // shows up in run time and peak RSS rather than here.
+    perf.Measure("routing", [&] {
+        if (opts.routing == "global")
+            Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+        if (opts.fastAssociate)
+            SetLeafGateways(cameras, edges, [&configs](uint32_t cam) { return configs[cam].edgeId; },
+                            NodeContainer(edges, clouds, control));
+    });
+    uint64_t routes = CountRoutes(all);
+
+    // Every on-link neighbour is known from the address plan, so no camera
+    // needs to ARP when the applications start.
+    if (opts.populateArp)
+        perf.Measure("arp", [] { NeighborCacheHelper().PopulateNeighborCache(); });
+
+    /* ================= MOBILITY ================= */
+    MobilityHelper mob;
+    mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mob.Install(all);
+
+    // Positions are final from here on.
+    for (uint32_t m = 0; m < numMedia; m++)
+        if (propagation[m])
+            propagation[m]->Precompute(mediumNodes[m]);
+
+    auto procNodeOf = [&](const CameraConfig& c) -> Ptr<Node> {
+        return (c.processing == "camera") ? cameras.Get(c.id) :
+               (c.processing == "edge")   ? edges.Get(c.edgeId) :
+                                            clouds.Get(c.cloudId);
+    };
+
+    /* ================= FRAME FLOWS (CAM → EDGE/CLOUD) ================= */
+    // frames: one burst of MTU-sized fragments per frame interval, received
+    // by a FrameSinkApp that measures per-frame latency.
+    // server: the processing node's InferenceServer receives the frames and
+    // sends one result per processed frame instead of the open-loop flow.
+    std::vector<Ptr<FrameSinkApp>> frameSinks(numCameras);
+    InferenceServers servers(opts.computeSlots, opts.queueLimit, opts.batchMax, Seconds(opts.batchWait),
+                             Seconds(kAppStart), Seconds(kAppStop));
+    Ptr<ResultSinkApp> resultSink;
+    if (opts.inference == "server") {
+        resultSink = CreateObject<ResultSinkApp>();
+        control.Get(0)->AddApplication(resultSink);
+    }
+    for (auto &c : configs) {
+        Ptr<Node> dst = procNodeOf(c);
+        if (opts.inference == "server") {
+            InstallCameraFrameApp(cameras.Get(c.id), c.id,
+                                  InetSocketAddress(PrimaryAddress(dst), kFramePortBase + c.id),
+                                  c.frameSize, Seconds(c.frameInterval), Seconds(kAppStart), Seconds(kAppStop));
+            servers.On(dst, c.processing != "camera")
+                ->AddCamera(c.id, kFramePortBase + c.id, c.model, Seconds(c.inferenceDelay), GetBatchScaling(c.model),
+                            c.resultSize, InetSocketAddress(PrimaryAddress(control.Get(0)), kResultPortBase + c.id));
+            resultSink->AddCamera(c.id, kResultPortBase + c.id);
+            continue;
         }
-
-        /* ================= FRAME FLOWS (CAM → EDGE/CLOUD) ================= */
-        for (auto &c : configs) {
-            Ptr<Node> dst =
-                (c.processing == "camera") ? cameras.Get(c.id) :
-                (c.processing == "edge")   ? edges.Get(c.edgeId) :
-                                             clouds.Get(c.cloudId);
-
-            OnOffHelper src("ns3::UdpSocketFactory",
-                InetSocketAddress(dst->GetObject<Ipv4>()->GetAddress(1,0).GetLocal(), 9000 + c.id));
-
-            src.SetConstantRate(DataRate(c.frameSize * 8 / c.frameInterval), c.frameSize);
-            auto app = src.Install(cameras.Get(c.id));
-            app.Start(Seconds(1.0));
-            app.Stop(Seconds(20.0));
+        if (opts.cameraApp == "frames") {
+            frameSinks[c.id] = InstallFrameFlow(cameras.Get(c.id), c.id, dst, PrimaryAddress(dst),
+                                                kFramePortBase + c.id, c.frameSize, Seconds(c.frameInterval),
+                                                Seconds(kAppStart), Seconds(kAppStop));
+            continue;
         }
 
-        /* ================= RESULT FLOWS (PROCESS → CONTROL) ================= */
+        OnOffHelper src("ns3::UdpSocketFactory",
+            InetSocketAddress(PrimaryAddress(dst), kFramePortBase + c.id));
+
+        src.SetConstantRate(DataRate(c.frameSize * 8 / c.frameInterval), c.frameSize);
+        auto app = src.Install(cameras.Get(c.id));
+        app.Start(Seconds(kAppStart));
+        app.Stop(Seconds(kAppStop));
+    }
+
+    /* ================= RESULT FLOWS (PROCESS → CONTROL) ================= */
+    if (opts.inference == "open") {
         for (auto &c : configs) {
-            Ptr<Node> procNode =
-                (c.processing == "camera") ? cameras.Get(c.id) :
-                (c.processing == "edge")   ? edges.Get(c.edgeId) :
-                                             clouds.Get(c.cloudId);
+            Ptr<Node> procNode = procNodeOf(c);
 
             OnOffHelper res("ns3::UdpSocketFactory",
-                InetSocketAddress(control.Get(0)->GetObject<Ipv4>()->GetAddress(1,0).GetLocal(), 10000 + c.id));
+                InetSocketAddress(PrimaryAddress(control.Get(0)), kResultPortBase + c.id));
 
             res.SetConstantRate(DataRate(c.resultSize * 8 / 0.5), c.resultSize);
             auto app = res.Install(procNode);
-            app.Start(Seconds(1.0 + c.inferenceDelay));
-            app.Stop(Seconds(20.0));
+            app.Start(Seconds(kAppStart + c.inferenceDelay));
+            app.Stop(Seconds(kAppStop));
+        }
+    }
+
+    /* ================= FLOW MONITOR ================= */
+    // Endpoints = cameras, processing nodes and control: flows are still
+    // classified at both ends, but forwarding hops carry no probes.
+    FlowMonitorHelper fm;
+    Ptr<FlowMonitor> monitor;
+    if (opts.monitor == "endpoints") {
+        NodeContainer endpoints;
+        std::set<uint32_t> seen;
+        auto addEndpoint = [&](Ptr<Node> n) { if (seen.insert(n->GetId()).second) endpoints.Add(n); };
+        for (auto &c : configs) {
+            addEndpoint(cameras.Get(c.id));
+            addEndpoint(procNodeOf(c));
         }
+        addEndpoint(control.Get(0));
+        monitor = fm.Install(endpoints);
+    } else {
+        monitor = fm.InstallAll();
+    }
 
-        /* ================= FLOW MONITOR ================= */
-        FlowMonitorHelper fm;
-        Ptr<FlowMonitor> monitor = fm.InstallAll();
+    // Only sources and destinations fire these traces, so all nodes is cheap.
+    FlowSketchMonitor sketches(opts.sketchAlpha);
+    if (opts.flowSketch)
+        sketches.Install(all);
+
+    FlowTimeSampler sampler(Seconds(opts.sampleStep));
+    if (opts.sampleStep > 0)
+        sampler.Start(monitor, Seconds(kSimStop));
+
+    QueueTracer queues(Seconds(opts.queueStep));
+    if (opts.queueStep > 0)
+        queues.Install(all, Seconds(kSimStop));
+
+    LinkUtilization links(Seconds(opts.linkStep));
+    if (opts.linkStep > 0) {
+        for (uint32_t b = 0; b < numBss; b++)
+            links.AddBss(numBss == 1 ? "wifi" : "bss" + std::to_string(b), bssDevs[b]);
+        links.Install(all, Seconds(kSimStop),
+                      NodeLabels({{"camera", cameras}, {"edge", edges}, {"cloud", clouds}, {"control", control}}));
+    }
 
-        Simulator::Stop(Seconds(22.0));
-        Simulator::Run();
+    Simulator::Stop(Seconds(kSimStop));
+    perf.SnapshotAt(Seconds(kAppStart + 1.0), monitor);
+    perf.RunStarted();
+    Simulator::Run();
+    perf.RunFinished();
+    sampler.Finish();
+    queues.Finish();
+    links.Finish();
+
+    /* ================= OUTPUT ================= */
+    // Everything that needs ns-3 is snapshotted here; formatting and I/O
+    // run on the writer thread while the next scenario is being built.
+    auto rows = std::make_shared<const std::vector<FlowRow>>(
+        CollectFlowRows(monitor, DynamicCast<Ipv4FlowClassifier>(fm.GetClassifier())));
+
+    ScenarioOutput out;
+    out.scenario = scenario;
+    out.dir = dir;
+
+    if (opts.flowFormat != "columnar") {
+        std::string xml = "<?xml version=\"1.0\" ?>\n" + monitor->SerializeToXmlString(0, true, true);
+        out.files.push_back({"flow.xml", [xml] { return xml; }});
+    }
+    if (opts.flowFormat != "xml")
+        out.files.push_back({"flow.bin", [rows] { return EncodeFlowColumns(*rows).Encode(); }});
+    if (opts.flowSketch) {
+        ColumnarTable buckets = sketches.EncodeBuckets(*rows);
+        ColumnarTable tails = sketches.EncodeTails(*rows);
+        out.files.push_back({"flow_sketch.bin", [buckets] { return buckets.Encode(); }});
+        out.files.push_back({"flow_tails.bin", [tails] { return tails.Encode(); }});
+    }
+    if (opts.sampleStep > 0) {
+        ColumnarTable series = sampler.Table();
+        out.files.push_back({"timeseries.bin", [series] { return series.Encode(); }});
+    }
+    if (opts.queueStep > 0) {
+        auto samples = std::make_shared<const std::vector<QueueSample>>(queues.Snapshot());
+        out.files.push_back({"network_log.csv", [samples] { return QueueLogCsv(*samples); }});
+    }
+    if (opts.linkStep > 0) {
+        // Paths come from the routing tables, so the report is built here.
+        ColumnarTable series = links.Series();
+        std::string report = links.Report(*rows, opts.hotLinks).dump(2);
+        out.files.push_back({"link_util.bin", [series] { return series.Encode(); }});
+        out.files.push_back({"link_report.json", [report] { return report; }});
+    }
 
-        /* ================= OUTPUT FOLDERS ================= */
-        std::ostringstream dir;
-        dir << "outputs/scenario_" << std::setw(3) << std::setfill('0') << scenario;
-        fs::create_directories(dir.str());  
+    json meta = ConfigJson(scenario, configs);
+    meta["monitor"] = opts.monitor;
+    meta["addressing"] = opts.addressing;
+    meta["populate_arp"] = opts.populateArp;
+    meta["fast_associate"] = opts.fastAssociate;
+    if (opts.flowSketch)
+        meta["flow_sketch"] = {{"alpha", sketches.Alpha()}, {"max_buckets", sketches.MaxBuckets()},
+                               {"flows", sketches.Flows()}};
+    if (opts.sampleStep > 0)
+        meta["timeseries"] = {{"step_s", opts.sampleStep}, {"samples", sampler.Samples()},
+                              {"rows", sampler.Table().Rows()}};
+    if (opts.queueStep > 0)
+        meta["queue_log"] = {{"step_s", opts.queueStep}, {"nodes", queues.Nodes()}, {"samples", queues.Samples()}};
+    if (opts.linkStep > 0)
+        meta["link_util"] = {{"step_s", opts.linkStep}, {"hot_links", opts.hotLinks}};
+    meta["camera_app"] = opts.cameraApp;
+    meta["inference"] = {{"mode", opts.inference}};
+    if (opts.inference == "server") {
+        meta["inference"]["slots"] = opts.computeSlots;
+        meta["inference"]["queue_limit"] = opts.queueLimit;
+        meta["inference"]["batch_max"] = opts.batchMax;
+        meta["inference"]["batch_wait_s"] = opts.batchWait;
+        meta["inference"]["servers"] = servers.Json();
+        meta["inference"]["e2e"] = resultSink->Json();
+    }
+    meta["bss"] = opts.bss;
+    meta["channel_plan"] = opts.channelPlan;
+    if (!mediumChannel.empty())
+        meta["channels"] = plan.Json();
+    meta["routing"] = {{"mode", opts.routing}, {"routes", routes}};
+    meta["perf"] = perf.Json();
+    out.files.push_back({"config.json", [meta] { return meta.dump(4); }});
+
+    /* ================= CAMERA ↔ FLOW JOIN ================= */
+    FlowIndex flowIndex(*rows);
+    Ptr<Node> sink = control.Get(0);
+    json joined = json::array();
+    for (auto &c : configs) {
+        Ptr<Node> procNode = procNodeOf(c);
+        joined.push_back({
+            {"camera_id", c.id},
+            {"processing", c.processing},
+            {"model", c.model},
+            {"camera_node", cameras.Get(c.id)->GetId()},
+            {"processing_node", procNode->GetId()},
+            {"sink_node", sink->GetId()},
+            {"frame_flow", FlowRecord(flowIndex.Find(PrimaryAddress(procNode), kFramePortBase + c.id))},
+            {"result_flow", FlowRecord(flowIndex.Find(PrimaryAddress(sink), kResultPortBase + c.id))}
+        });
+        if (frameSinks[c.id])
+            joined.back()["frames"] = frameSinks[c.id]->Json();
+        if (opts.inference == "server") {
+            joined.back()["frames"] = servers.CameraJson(procNode, c.id);
+            joined.back()["e2e"] = resultSink->CameraJson(c.id);
+        }
+    }
+    out.files.push_back({"camera_flows.json", [joined] { return joined.dump(4); }});
+
+    // config.json is cached without the scenario index, which a hit stamps
+    // back in, so hits and misses write the same meta.
+    if (opts.useCache) {
+        json stored = meta;
+        stored.erase("scenario");
+        out.done = [cache, key, stored](const ArchiveFiles& files) {
+            ArchiveFiles entry = files;
+            for (auto &[name, bytes] : entry)
+                if (name == "config.json") bytes = stored.dump(4);
+            cache.Store(key, entry, {});
+        };
+    }
 
-        monitor->SerializeToXmlFile(dir.str() + "/flow.xml", true, true);
+    // Drop leftovers of an earlier run (possibly in another format).
+    if (opts.archive.empty())
+        fs::remove_all(dir);
+    writer.Submit(std::move(out));
 
-        json meta;
-        meta["scenario"] = scenario;
-        meta["cameras"] = json::array();
-        for (auto &c : configs)
-            meta["cameras"].push_back({
-                {"id", c.id},
-                {"processing", c.processing},
-                {"model", c.model},
-                {"inference_delay", c.inferenceDelay},
-                {"result_size", c.resultSize}
-            });
+    Simulator::Destroy();
+    return 0;
+}
 
-        std::ofstream cfg(dir.str() + "/config.json");
-        cfg << meta.dump(4);
-        cfg.close();
+/* ================= MAIN ================= */
+
+int main(int argc, char *argv[]) {
+
+    Time::SetResolution(Time::NS);
+    LogComponentEnable("WarehouseSimulation", LOG_LEVEL_INFO);
+
+    uint32_t scenarioCount = 100;
+    uint32_t firstScenario = 0;
+    uint32_t jobs = 1;
+    uint32_t seed = 1;
+    bool useCache = false;
+    std::string cacheDir = "outputs/.cache";
+    std::string flowFormat = "xml";
+    bool flowSketch = false;
+    double sketchAlpha = 0.01;
+    double sampleStep = 0;
+    double queueStep = 0;
+    double linkStep = 0;
+    uint32_t hotLinks = 5;
+    uint32_t writerQueue = 2;
+    bool syncOutputs = false;
+    std::string archive;
+    bool staticChannel = false;
+    std::string monitor = "all";
+    std::string addressing = "flat";
+    std::string routing = "global";
+    bool populateArp = false;
+    bool fastAssociate = false;
+    std::string bss = "shared";
+    std::string channelPlan = "unique";
+    std::string cameraApp = "onoff";
+    std::string inference = "open";
+    uint32_t computeSlots = 1;
+    uint32_t queueLimit = 0;
+    uint32_t batchMax = 1;
+    double batchWaitMs = 0;
+    CommandLine cmd;
+    cmd.AddValue("scenarios", "Number of scenarios", scenarioCount);
+    cmd.AddValue("firstScenario", "Index of the first scenario to run", firstScenario);
+    cmd.AddValue("jobs", "Scenarios to run in parallel child processes (0 = one per core)", jobs);
+    cmd.AddValue("seed", "ns-3 RngSeed used by every scenario", seed);
+    cmd.AddValue("cache", "Reuse results of previously simulated identical scenarios (same build)", useCache);
+    cmd.AddValue("cacheDir", "Directory of the scenario result cache", cacheDir);
+    cmd.AddValue("flowFormat", "Flow statistics output: xml, columnar (flow.bin) or both", flowFormat);
+    cmd.AddValue("flowSketch", "Per-flow delay/jitter quantile sketches (flow_sketch.bin, flow_tails.bin)", flowSketch);
+    cmd.AddValue("sketchAlpha", "Relative accuracy of the flow sketches", sketchAlpha);
+    cmd.AddValue("sampleStep", "Per-flow time series step in seconds (timeseries.bin); 0 = off", sampleStep);
+    cmd.AddValue("queueStep", "Per-node queue occupancy log step in seconds (network_log.csv); 0 = off", queueStep);
+    cmd.AddValue("linkStep", "Link/BSS utilization step in seconds (link_util.bin, link_report.json); 0 = off", linkStep);
+    cmd.AddValue("hotLinks", "Most utilized links/BSSes whose flows are listed in link_report.json", hotLinks);
+    cmd.AddValue("writerQueue", "Scenarios buffered for the background writer (0 = write inline)", writerQueue);
+    cmd.AddValue("fsync", "fsync every output file before moving on", syncOutputs);
+    cmd.AddValue("archive", "Write all scenarios into this single indexed archive file", archive);
+    cmd.AddValue("staticChannel", "Precompute Wi-Fi propagation loss/delay between static nodes", staticChannel);
+    cmd.AddValue("addressing", "flat (one 10.0.0.0/16) or hier (per-BSS and per-link-group subnets)", addressing);
+    cmd.AddValue("routing", "global (SPF over all nodes) or nix (on-demand nix vectors)", routing);
+    cmd.AddValue("populateArp", "Pre-populate all neighbour (ARP) caches before the run", populateArp);
+    cmd.AddValue("fastAssociate", "Skip beacons/association: ad hoc Wi-Fi with cameras routed via their edgeId edge", fastAssociate);
+    cmd.AddValue("bss", "shared (one SSID and channel) or perAp (own SSID and channel per edge)", bss);
+    cmd.AddValue("channelPlan", "With --bss=perAp: unique (own channel object per BSS) or plan real channels over 2.4, 5 or dual bands", channelPlan);
+    cmd.AddValue("cameraApp", "Frame source: onoff (constant-rate packets) or frames (per-frame fragment bursts with latency)", cameraApp);
+    cmd.AddValue("inference", "Results: open (fixed-rate flow per camera) or server (one result per frame processed by an InferenceServer)", inference);
+    cmd.AddValue("computeSlots", "Frames each InferenceServer processes in parallel", computeSlots);
+    cmd.AddValue("queueLimit", "Frames waiting per InferenceServer before drops (0 = unbounded)", queueLimit);
+    cmd.AddValue("batchMax", "Frames of one model an InferenceServer on a shared node runs as one batch", batchMax);
+    cmd.AddValue("batchWaitMs", "Longest a frame waits for its batch to fill (ms)", batchWaitMs);
+    cmd.AddValue("monitor", "FlowMonitor probes on all nodes, or only on endpoints (cameras, processing nodes, control)", monitor);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(flowFormat != "xml" && flowFormat != "columnar" && flowFormat != "both",
+                    "Unknown --flowFormat " << flowFormat);
+    NS_ABORT_MSG_IF(sketchAlpha <= 0 || sketchAlpha >= 1, "--sketchAlpha must be in (0, 1)");
+    NS_ABORT_MSG_IF(sampleStep < 0, "--sampleStep must not be negative");
+    NS_ABORT_MSG_IF(queueStep < 0, "--queueStep must not be negative");
+    NS_ABORT_MSG_IF(linkStep < 0, "--linkStep must not be negative");
+    NS_ABORT_MSG_IF(cameraApp != "onoff" && cameraApp != "frames", "Unknown --cameraApp " << cameraApp);
+    NS_ABORT_MSG_IF(inference != "open" && inference != "server", "Unknown --inference " << inference);
+    NS_ABORT_MSG_IF(inference == "server" && cameraApp != "frames", "--inference=server needs --cameraApp=frames");
+    NS_ABORT_MSG_IF(computeSlots < 1, "--computeSlots must be at least 1");
+    NS_ABORT_MSG_IF(batchMax < 1 || batchWaitMs < 0, "--batchMax must be at least 1 and --batchWaitMs not negative");
+    NS_ABORT_MSG_IF(monitor != "all" && monitor != "endpoints", "Unknown --monitor " << monitor);
+    NS_ABORT_MSG_IF(addressing != "flat" && addressing != "hier", "Unknown --addressing " << addressing);
+    NS_ABORT_MSG_IF(routing != "global" && routing != "nix", "Unknown --routing " << routing);
+    NS_ABORT_MSG_IF(bss != "shared" && bss != "perAp", "Unknown --bss " << bss);
+    NS_ABORT_MSG_IF(channelPlan != "unique" && AvailableChannels(channelPlan).empty(), "Unknown --channelPlan " << channelPlan);
+    NS_ABORT_MSG_IF(channelPlan != "unique" && bss != "perAp", "--channelPlan needs --bss=perAp");
+    NS_ABORT_MSG_IF(fastAssociate && routing == "nix", "--fastAssociate needs --routing=global");
+
+    // Create top-level outputs folder
+    fs::create_directories("outputs");
 
-        Simulator::Destroy();
+    // --RngRun (default 1) is shared by all scenarios so that equal
+    // parameters really do mean an equal simulation.
+    ScenarioOptions opts{};
+    opts.seed = seed;
+    opts.run = RngSeedManager::GetRun();
+    opts.useCache = useCache;
+    opts.cacheDir = cacheDir;
+    opts.flowFormat = flowFormat;
+    opts.flowSketch = flowSketch;
+    opts.sketchAlpha = sketchAlpha;
+    opts.sampleStep = sampleStep;
+    opts.queueStep = queueStep;
+    opts.linkStep = linkStep;
+    opts.hotLinks = hotLinks;
+    opts.archive = archive;
+    opts.staticChannel = staticChannel;
+    opts.monitor = monitor;
+    opts.addressing = addressing;
+    opts.routing = routing;
+    opts.populateArp = populateArp;
+    opts.fastAssociate = fastAssociate;
+    opts.bss = bss;
+    opts.channelPlan = channelPlan;
+    opts.cameraApp = cameraApp;
+    opts.inference = inference;
+    opts.computeSlots = computeSlots;
+    opts.queueLimit = queueLimit;
+    opts.batchMax = batchMax;
+    opts.batchWait = batchWaitMs / 1000.0;
+
+    // Cache keys carry the build, so rebuilt code never serves old results.
+    if (opts.useCache) {
+        opts.build = BuildFingerprint();
+        if (opts.build.empty()) {
+            NS_LOG_WARN("Cannot fingerprint the simulator build; result cache disabled");
+            opts.useCache = false;
+        }
     }
 
-    NS_LOG_INFO("All scenarios completed.");
-    return 0;
+    NS_ABORT_MSG_IF(!archive.empty() && !ScenarioArchiveWriter(archive).Create(),
+                    "Cannot create archive " << archive);
+
+    // In-process sweeps share one writer, so output overlaps the next
+    // scenario. Forked sweeps give every scenario its own writer, closed
+    // before returning: the child exits right after, and a scenario run in
+    // the parent (fork failed) must not leave a thread behind for the
+    // children forked later.
+    std::unique_ptr<AsyncOutputWriter> writer;
+    bool forked = ResolveJobs(jobs) > 1;
+
+    auto results = RunScenarioSweep(firstScenario, scenarioCount, jobs,
+        [&](uint32_t scenario) {
+            if (forked) {
+                AsyncOutputWriter own(writerQueue, syncOutputs, archive);
+                int rc = RunScenario(scenario, opts, own);
+                return own.Close() > 0 ? 1 : rc;
+            }
+            if (!writer) writer.reset(new AsyncOutputWriter(writerQueue, syncOutputs, archive));
+            return RunScenario(scenario, opts, *writer);
+        },
+        [&](uint32_t scenario) { return archive.empty() ? ScenarioDir(scenario) : archive; });
+
+    bool writeFailed = writer && writer->Close() > 0;
+    if (!archive.empty() && !ScenarioArchiveWriter(archive).Finalize())
+        writeFailed = true;
+    if (writeFailed)
+        NS_LOG_ERROR("Some scenario outputs could not be written");
+
+    uint32_t failed = 0;
+    for (auto &r : results) {
+        if (r.status != 0) {
+            NS_LOG_ERROR("Scenario " << r.scenario << " failed with status " << r.status
+                         << " (" << r.outputDir << ")");
+            failed++;
+        }
+    }
+
+    NS_LOG_INFO("All scenarios completed (" << results.size() - failed << "/" << results.size() << " ok).");
+    return (failed || writeFailed) ? 1 : 0;
 }